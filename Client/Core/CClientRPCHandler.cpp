@@ -38,6 +38,7 @@
 #include "CFireManager.h"
 #include "CGame.h"
 #include "CStreamer.h"
+#include <zlib.h>
 
 extern String                 g_strNick;
 extern String                 g_strHost;
@@ -1088,12 +1089,13 @@ void CClientRPCHandler::OnFootSync(CBitStream * pBitStream, CPlayerSocket * pSen
 	pBitStream->ReadCompressed(usPing);
 	pBitStream->ReadCompressed(m_bHelmet);
 
-	pBitStream->Read((char *)&syncPacket, sizeof(OnFootSyncData));
+	if(!pBitStream->Read(syncPacket))
+		return;
 
 	bool bHasAimSyncData = pBitStream->ReadBit();
 
 	if(bHasAimSyncData)
-		pBitStream->Read((char *)&aimSyncPacket, sizeof(AimSyncData));
+		pBitStream->Read(aimSyncPacket);
 
 	CNetworkPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
 	if(pPlayer && pPlayer->IsSpawned())
@@ -1134,12 +1136,13 @@ void CClientRPCHandler::InVehicleSync(CBitStream * pBitStream, CPlayerSocket * p
 	pBitStream->ReadCompressed(vehicleId);
 	pBitStream->ReadCompressed(usPing);
 	pBitStream->ReadCompressed(m_bHelmet);
-	pBitStream->Read((char *)&syncPacket, sizeof(InVehicleSyncData));
+	if(!pBitStream->Read(syncPacket))
+		return;
 
 	bool bHasAimSyncData = pBitStream->ReadBit();
 
 	if(bHasAimSyncData)
-		pBitStream->Read((char *)&aimSyncPacket, sizeof(AimSyncData));
+		pBitStream->Read(aimSyncPacket);
 
 	CNetworkPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
 	if(pPlayer && pPlayer->IsSpawned())
@@ -1164,6 +1167,82 @@ void CClientRPCHandler::InVehicleSync(CBitStream * pBitStream, CPlayerSocket * p
 	}
 }
 
+void CClientRPCHandler::VehicleState(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
+{
+	// Ensure we have a valid bit stream
+	if(!pBitStream)
+		return;
+
+	EntityId vehicleId;
+	VehicleStateData stateData;
+
+	if(!pBitStream->ReadCompressed(vehicleId))
+		return;
+
+	if(!pBitStream->Read(stateData))
+		return;
+
+	CNetworkVehicle * pVehicle = g_pVehicleManager->Get(vehicleId);
+
+	if(!pVehicle)
+		return;
+
+	// Set their vehicles color
+	if(stateData.usFlags & VEHICLE_STATE_COLORS)
+		pVehicle->SetColors(stateData.byteColors[0], stateData.byteColors[1], stateData.byteColors[2], stateData.byteColors[3]);
+
+	// Set their vehicles dirt level
+	if(stateData.usFlags & VEHICLE_STATE_DIRT_LEVEL)
+		pVehicle->SetDirtLevel(stateData.fDirtLevel);
+
+	// Set their door states
+	if(stateData.usFlags & VEHICLE_STATE_DOORS)
+	{
+		for(int i = 0; i <= 5; i++)
+		{
+			if(pVehicle->GetCarDoorAngle(i) != stateData.fDoor[i])
+				pVehicle->SetCarDoorAngle(i, false, stateData.fDoor[i]);
+		}
+	}
+
+	// Set their vehicles engine status
+	if(stateData.usFlags & VEHICLE_STATE_ENGINE)
+		pVehicle->SetEngineState(stateData.bEngineStatus);
+
+	// Set their lights
+	if(stateData.usFlags & VEHICLE_STATE_LIGHTS)
+		pVehicle->SetLightsState(stateData.bLights);
+
+	// Set their taxi lights
+	if(stateData.usFlags & VEHICLE_STATE_TAXI_LIGHTS)
+		pVehicle->SetTaxiLightsState(stateData.bTaxiLights);
+
+	// Set their vehicles siren state
+	if(stateData.usFlags & VEHICLE_STATE_SIREN)
+		pVehicle->SetSirenState(stateData.bSirenState);
+
+	// Set their gps state
+	if(stateData.usFlags & VEHICLE_STATE_GPS)
+		pVehicle->SetVehicleGPSState(stateData.bGpsState);
+
+	// Set their windows
+	if(stateData.usFlags & VEHICLE_STATE_WINDOWS)
+	{
+		for(int i = 0; i <= 3; i++)
+			pVehicle->SetWindowState(i, stateData.bWindow[i]);
+	}
+
+	// Set their tyres
+	if((stateData.usFlags & VEHICLE_STATE_TYRES) && pVehicle->IsStreamedIn())
+	{
+		for(int i = 0; i <= 5; i++)
+		{
+			if(stateData.bTyre[i])
+				Scripting::BurstCarTyre(pVehicle->GetScriptingHandle(), (Scripting::eVehicleTyre)i);
+		}
+	}
+}
+
 void CClientRPCHandler::PassengerSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
 {
 	// Ensure we have a valid bit stream
@@ -1184,7 +1263,7 @@ void CClientRPCHandler::PassengerSync(CBitStream * pBitStream, CPlayerSocket * p
 	bool bHasAimSyncData = pBitStream->ReadBit();
 
 	if(bHasAimSyncData)
-		pBitStream->Read((char *)&aimSyncPacket, sizeof(AimSyncData));
+		pBitStream->Read(aimSyncPacket);
 
 	CNetworkPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
 	if(pPlayer && pPlayer->IsSpawned())
@@ -1225,7 +1304,7 @@ void CClientRPCHandler::SmallSync(CBitStream * pBitStream, CPlayerSocket * pSend
 	bool bHasAimSyncData = pBitStream->ReadBit();
 
 	if(bHasAimSyncData)
-		pBitStream->Read((char *)&aimSyncPacket, sizeof(AimSyncData));
+		pBitStream->Read(aimSyncPacket);
 
 	CNetworkPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
 	if(pPlayer && pPlayer->IsSpawned())
@@ -1245,6 +1324,115 @@ void CClientRPCHandler::SmallSync(CBitStream * pBitStream, CPlayerSocket * pSend
 	}
 }
 
+void CClientRPCHandler::BatchedSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
+{
+	// Ensure we have a valid bit stream
+	if(!pBitStream)
+		return;
+
+	unsigned char ucCount;
+
+	if(!pBitStream->Read(ucCount))
+		return;
+
+	for(unsigned char uc = 0; uc < ucCount; uc++)
+	{
+		RPCIdentifier rpcId;
+		unsigned int uiSizeInBits;
+		CBitStream bsSync;
+
+		// Read the sync rpc id and data
+		if(!pBitStream->Read(rpcId) || !pBitStream->ReadUInt(uiSizeInBits, SYNC_BATCH_ENTRY_SIZE_BITS) || 
+			!pBitStream->Read(&bsSync, uiSizeInBits))
+		{
+			return;
+		}
+
+		// Pass the sync to its handler
+		switch(rpcId)
+		{
+		case RPC_OnFootSync:
+			OnFootSync(&bsSync, pSenderSocket);
+			break;
+		case RPC_InVehicleSync:
+			InVehicleSync(&bsSync, pSenderSocket);
+			break;
+		case RPC_PassengerSync:
+			PassengerSync(&bsSync, pSenderSocket);
+			break;
+		case RPC_SmallSync:
+			SmallSync(&bsSync, pSenderSocket);
+			break;
+		}
+	}
+}
+
+void CClientRPCHandler::WorldSnapshot(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
+{
+	// Ensure we have a valid bit stream
+	if(!pBitStream)
+		return;
+
+	unsigned short usChunk;
+	unsigned short usChunkCount;
+	unsigned int uiRpcCount;
+	unsigned int uiSize;
+
+	if(!pBitStream->Read(usChunk) || !pBitStream->Read(usChunkCount) || !pBitStream->Read(uiRpcCount) || !pBitStream->Read(uiSize))
+		return;
+
+	std::vector<unsigned char>& snapshotData = g_pNetworkManager->GetSnapshotData();
+
+	// Is this the first chunk of a new snapshot section?
+	if(usChunk == 0)
+		snapshotData.clear();
+
+	// Append the chunk to the compressed snapshot data
+	unsigned int uiChunkSize = pBitStream->GetNumberOfUnreadBytes();
+
+	if(uiChunkSize > 0)
+	{
+		size_t sOffset = snapshotData.size();
+		snapshotData.resize(sOffset + uiChunkSize);
+		pBitStream->Read((char *)&snapshotData[sOffset], uiChunkSize);
+	}
+
+	// Wait until we have all chunks
+	if((usChunk + 1) < usChunkCount)
+		return;
+
+	// Decompress the snapshot section
+	std::vector<unsigned char> uncompressedData(uiSize);
+	uLongf ulSize = (uLongf)uiSize;
+
+	if(uiSize == 0 || snapshotData.empty() || uncompress(&uncompressedData[0], &ulSize, &snapshotData[0], (uLong)snapshotData.size()) != Z_OK || ulSize != uiSize)
+	{
+		CLogFile::Printf("Failed to decompress world snapshot (%d bytes)", (int)snapshotData.size());
+		snapshotData.clear();
+		return;
+	}
+
+	snapshotData.clear();
+
+	// Pass each captured rpc to its handler
+	CBitStream bsSnapshot(&uncompressedData[0], uiSize, false);
+
+	for(unsigned int i = 0; i < uiRpcCount; i++)
+	{
+		RPCIdentifier rpcId;
+		unsigned int uiSizeInBits;
+		CBitStream bsRpc;
+
+		if(!bsSnapshot.Read(rpcId) || !bsSnapshot.ReadCompressed(uiSizeInBits) || !bsSnapshot.Read(&bsRpc, uiSizeInBits))
+			break;
+
+		RPCFunction * pFunction = g_pNetworkManager->GetRPCHandler()->GetFunctionFromIdentifier(rpcId);
+
+		if(pFunction)
+			pFunction->rpcFunction(&bsRpc, pSenderSocket);
+	}
+}
+
 void CClientRPCHandler::EmptyVehicleSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
 {
 //	// Ensure we have a valid bit stream
@@ -2418,19 +2606,16 @@ void CClientRPCHandler::ScriptingEventCall(CBitStream * pBitStream, CPlayerSocke
 	if(!pBitStream)
 		return;
 
-	CSquirrelArguments* pArgs = new CSquirrelArguments(pBitStream);
-	CSquirrelArgument* pEventName = pArgs->size() > 0 ? pArgs->front() : 0;
+	CSquirrelArguments arguments(pBitStream);
+	CSquirrelArgument* pEventName = arguments.size() > 0 ? arguments.front() : 0;
 
 	if(pEventName && pEventName->GetType() == OT_STRING)
 	{
-		const char* szEventName = pEventName->data.str->C_String();
-		pArgs->pop_front();
+		String strEventName = pEventName->GetString();
+		arguments.pop_front();
 
-		g_pEvents->Call(szEventName, pArgs);
+		g_pEvents->Call(strEventName, &arguments);
 	}
-
-	delete pEventName;
-	delete pArgs;
 }
 
 void CClientRPCHandler::ScriptingSetPlayerColor(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
@@ -3614,8 +3799,11 @@ void CClientRPCHandler::Register()
 	AddFunction(RPC_Chat, Chat);
 	AddFunction(RPC_OnFootSync, OnFootSync);
 	AddFunction(RPC_InVehicleSync, InVehicleSync);
+	AddFunction(RPC_VehicleState, VehicleState);
 	AddFunction(RPC_PassengerSync, PassengerSync);
 	AddFunction(RPC_SmallSync, SmallSync);
+	AddFunction(RPC_BatchedSync, BatchedSync);
+	AddFunction(RPC_WorldSnapshot, WorldSnapshot);
 	AddFunction(RPC_EmptyVehicleSync, EmptyVehicleSync);
 	AddFunction(RPC_Message, Message);
 	AddFunction(RPC_ConnectionRefused, ConnectionRefused);
@@ -3782,8 +3970,11 @@ void CClientRPCHandler::Unregister()
 	RemoveFunction(RPC_Chat);
 	RemoveFunction(RPC_OnFootSync);
 	RemoveFunction(RPC_InVehicleSync);
+	RemoveFunction(RPC_VehicleState);
 	RemoveFunction(RPC_PassengerSync);
 	RemoveFunction(RPC_SmallSync);
+	RemoveFunction(RPC_BatchedSync);
+	RemoveFunction(RPC_WorldSnapshot);
 	RemoveFunction(RPC_EmptyVehicleSync);
 	RemoveFunction(RPC_Message);
 	RemoveFunction(RPC_ConnectionRefused);
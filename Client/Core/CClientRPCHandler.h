@@ -40,8 +40,11 @@ private:
 	static void Chat(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void OnFootSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void InVehicleSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
+	static void VehicleState(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void PassengerSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void SmallSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
+	static void BatchedSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
+	static void WorldSnapshot(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void EmptyVehicleSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void Message(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void ConnectionRefused(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
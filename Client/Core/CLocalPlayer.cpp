@@ -87,7 +87,8 @@ CLocalPlayer::CLocalPlayer() : CNetworkPlayer(true),
 	m_ulLastPureSyncTime(0),
 	m_uiLastInterior(0),
 	m_bDisableVehicleInfo(false),
-	m_bFirstSpawn(false)
+	m_bFirstSpawn(false),
+	m_lastVehicleStateVehicleId(INVALID_ENTITY_ID)
 {
 	//m_bAnimating = false;
 	
@@ -276,6 +277,9 @@ void CLocalPlayer::SetPlayerControlAdvanced(bool bControl, bool bCamera)
 
 void CLocalPlayer::SendOnFootSync()
 {
+	// We are not driving, send the full vehicle state the next time we are
+	m_lastVehicleStateVehicleId = INVALID_ENTITY_ID;
+
 	CBitStream bsSend;
 	OnFootSyncData syncPacket;
 
@@ -310,9 +314,9 @@ void CLocalPlayer::SendOnFootSync()
 	syncPacket.uHealthArmour = ((GetHealth() << 16) | GetArmour());
 
 	// Set default animation stuff
-	/*syncPacket.bAnim = false;
+	syncPacket.bAnim = false;
 
-	// Check for anims
+	/*// Check for anims
 	// TODO Fix animation system
 	if(m_bAnimating)
 	{
@@ -334,7 +338,7 @@ void CLocalPlayer::SendOnFootSync()
 	syncPacket.uWeaponInfo = ((uiCurrentWeapon << 20) | GetAmmo(uiCurrentWeapon));
 
 	// Write the on foot sync data to the bit stream
-	bsSend.Write((char *)&syncPacket, sizeof(OnFootSyncData));
+	bsSend.Write(syncPacket);
 
 	// Check if they are aiming or firing
 	// NOTE: Do i need to sync aim for combat too?
@@ -348,7 +352,7 @@ void CLocalPlayer::SendOnFootSync()
 		GetAimSyncData(&aimSyncPacket);
 
 		// Write the aim sync data to the bit stream
-		bsSend.Write((char *)&aimSyncPacket, sizeof(AimSyncData));
+		bsSend.Write(aimSyncPacket);
 	}
 	else
 	{
@@ -397,12 +401,6 @@ void CLocalPlayer::SendInVehicleSync()
 		// Get their vehicles rotation
 		pVehicle->GetRotation(syncPacket.vecRotation);
 
-		// Get their vehicles colors
-		pVehicle->GetColors(syncPacket.byteColors[0], syncPacket.byteColors[1], syncPacket.byteColors[2], syncPacket.byteColors[3]);
-
-		// Get their vehicles siren state
-		syncPacket.bSirenState = pVehicle->GetSirenState();
-
 		// Get their vehicles turn speed
 		pVehicle->GetTurnSpeed(syncPacket.vecTurnSpeed);
 
@@ -416,24 +414,10 @@ void CLocalPlayer::SendInVehicleSync()
 		syncPacket.uiHealth = pVehicle->GetHealth();
 		syncPacket.fPetrolHealth = (float)pVehicle->GetPetrolTankHealth();
 
-		// Get their vehicles dirt level
-		syncPacket.fDirtLevel = pVehicle->GetDirtLevel();
-
-		// Get their lights
-		syncPacket.bLights = pVehicle->GetLightsState();
-
 		// Get vehicle deformation
 		//CVector3 vecPos;
 		//pVehicle->GetDeformation(vecPos);
 
-		// Get the door stuff
-		syncPacket.fDoor[0] = pVehicle->GetCarDoorAngle(0);
-		syncPacket.fDoor[1] = pVehicle->GetCarDoorAngle(1);
-		syncPacket.fDoor[2] = pVehicle->GetCarDoorAngle(2);
-		syncPacket.fDoor[3] = pVehicle->GetCarDoorAngle(3);
-		syncPacket.fDoor[4] = pVehicle->GetCarDoorAngle(4);
-		syncPacket.fDoor[5] = pVehicle->GetCarDoorAngle(5);
-
 		// Get their health and armour
 		syncPacket.uPlayerHealthArmour = ((GetHealth() << 16) | GetArmour());
 
@@ -441,36 +425,11 @@ void CLocalPlayer::SendInVehicleSync()
 		unsigned int uCurrentWeapon = GetCurrentWeapon();
 		syncPacket.uPlayerWeaponInfo = ((uCurrentWeapon << 20) | GetAmmo(uCurrentWeapon));
 
-		// Get their vehicles engine status (untested)
-		syncPacket.bEngineStatus = pVehicle->GetEngineState();
-		
-		// Set default window and typres values & check them
-		for(int i = 0; i <= 5; i++)
-		{
-			if(i < 4)
-			{
-				syncPacket.bWindow[i] = false;
-				syncPacket.bTyre[i] = false;
-			}
-			else if(i > 3)
-				syncPacket.bTyre[i] = false;
-		}
-
-		
-		for(int i = 0; i <= 3; i++)
-		{
-			if(!Scripting::IsVehWindowIntact(pVehicle->GetScriptingHandle(),(Scripting::eVehicleWindow)i))
-				syncPacket.bWindow[i] = true;
-		}
-
-		for(int i = 0; i <= 5; i++)
-		{
-			if(Scripting::IsCarTyreBurst(pVehicle->GetScriptingHandle(),(Scripting::eVehicleTyre)i))
-				syncPacket.bTyre[i] = true;
-		}
+		// Send the vehicle state if it changed
+		SendVehicleState(pVehicle);
 
 		// Write the in vehicle sync data to the bit stream
-		bsSend.Write((char *)&syncPacket, sizeof(InVehicleSyncData));
+		bsSend.Write(syncPacket);
 
 		// Check if they are doing a drive by
 		if(syncPacket.controlState.IsDoingDriveBy())
@@ -483,7 +442,7 @@ void CLocalPlayer::SendInVehicleSync()
 			GetAimSyncData(&aimSyncPacket);
 
 			// Write the aim sync data to the bit stream
-			bsSend.Write((char *)&aimSyncPacket, sizeof(AimSyncData));
+			bsSend.Write(aimSyncPacket);
 		}
 		else
 		{
@@ -503,8 +462,105 @@ void CLocalPlayer::SendInVehicleSync()
 	}
 }
 
+void CLocalPlayer::SendVehicleState(CNetworkVehicle * pVehicle)
+{
+	VehicleStateData stateData;
+
+	// Get their vehicles colors
+	pVehicle->GetColors(stateData.byteColors[0], stateData.byteColors[1], stateData.byteColors[2], stateData.byteColors[3]);
+
+	// Get their vehicles dirt level
+	stateData.fDirtLevel = pVehicle->GetDirtLevel();
+
+	// Get the door stuff
+	for(int i = 0; i <= 5; i++)
+		stateData.fDoor[i] = pVehicle->GetCarDoorAngle(i);
+
+	// Get their vehicles engine status (untested)
+	stateData.bEngineStatus = pVehicle->GetEngineState();
+
+	// Get their lights
+	stateData.bLights = pVehicle->GetLightsState();
+
+	// Get their vehicles taxi light state
+	stateData.bTaxiLights = pVehicle->GetTaxiLightsState();
+
+	// Get their vehicles siren state
+	stateData.bSirenState = pVehicle->GetSirenState();
+
+	// Get their vehicles gps state
+	stateData.bGpsState = pVehicle->GetVehicleGPSState();
+
+	// Get their windows
+	for(int i = 0; i <= 3; i++)
+		stateData.bWindow[i] = !Scripting::IsVehWindowIntact(pVehicle->GetScriptingHandle(), (Scripting::eVehicleWindow)i);
+
+	// Get their tyres
+	for(int i = 0; i <= 5; i++)
+		stateData.bTyre[i] = Scripting::IsCarTyreBurst(pVehicle->GetScriptingHandle(), (Scripting::eVehicleTyre)i);
+
+	// Compare the floats as they are sent so changes too small for the sync don't cause a resend
+	CBitStream::QuantizeVehicleState(stateData);
+
+	// Work out which states changed since we last sent them (everything if this is a different vehicle)
+	unsigned short usFlags = 0;
+
+	if(m_lastVehicleStateVehicleId != pVehicle->GetVehicleId())
+		usFlags = VEHICLE_STATE_ALL;
+	else
+	{
+		if(memcmp(stateData.byteColors, m_lastVehicleStateSent.byteColors, sizeof(stateData.byteColors)))
+			usFlags |= VEHICLE_STATE_COLORS;
+
+		if(stateData.fDirtLevel != m_lastVehicleStateSent.fDirtLevel)
+			usFlags |= VEHICLE_STATE_DIRT_LEVEL;
+
+		if(memcmp(stateData.fDoor, m_lastVehicleStateSent.fDoor, sizeof(stateData.fDoor)))
+			usFlags |= VEHICLE_STATE_DOORS;
+
+		if(stateData.bEngineStatus != m_lastVehicleStateSent.bEngineStatus)
+			usFlags |= VEHICLE_STATE_ENGINE;
+
+		if(stateData.bLights != m_lastVehicleStateSent.bLights)
+			usFlags |= VEHICLE_STATE_LIGHTS;
+
+		if(stateData.bTaxiLights != m_lastVehicleStateSent.bTaxiLights)
+			usFlags |= VEHICLE_STATE_TAXI_LIGHTS;
+
+		if(stateData.bSirenState != m_lastVehicleStateSent.bSirenState)
+			usFlags |= VEHICLE_STATE_SIREN;
+
+		if(stateData.bGpsState != m_lastVehicleStateSent.bGpsState)
+			usFlags |= VEHICLE_STATE_GPS;
+
+		if(memcmp(stateData.bWindow, m_lastVehicleStateSent.bWindow, sizeof(stateData.bWindow)))
+			usFlags |= VEHICLE_STATE_WINDOWS;
+
+		if(memcmp(stateData.bTyre, m_lastVehicleStateSent.bTyre, sizeof(stateData.bTyre)))
+			usFlags |= VEHICLE_STATE_TYRES;
+	}
+
+	// Has anything changed?
+	if(usFlags == 0)
+		return;
+
+	// Update the last sent vehicle state
+	stateData.usFlags = usFlags;
+	memcpy(&m_lastVehicleStateSent, &stateData, sizeof(VehicleStateData));
+	m_lastVehicleStateVehicleId = pVehicle->GetVehicleId();
+
+	// Send the changed states reliably
+	CBitStream bsSend;
+	bsSend.WriteCompressed(pVehicle->GetVehicleId());
+	bsSend.Write(stateData);
+	g_pNetworkManager->RPC(RPC_VehicleState, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+}
+
 void CLocalPlayer::SendPassengerSync()
 {
+	// We are not driving, send the full vehicle state the next time we are
+	m_lastVehicleStateVehicleId = INVALID_ENTITY_ID;
+
 	CNetworkVehicle * pVehicle = GetVehicle();
 
 	if(pVehicle && pVehicle->IsStreamedIn())
@@ -549,7 +605,7 @@ void CLocalPlayer::SendPassengerSync()
 			GetAimSyncData(&aimSyncPacket);
 
 			// Write the aim sync data to the bit stream
-			bsSend.Write((char *)&aimSyncPacket, sizeof(AimSyncData));
+			bsSend.Write(aimSyncPacket);
 		}
 		else
 		{
@@ -593,7 +649,7 @@ void CLocalPlayer::SendSmallSync()
 		GetAimSyncData(&aimSyncPacket);
 
 		// Write the aim sync data to the bit stream
-		bsSend.Write((char *)&aimSyncPacket, sizeof(AimSyncData));
+		bsSend.Write(aimSyncPacket);
 	}
 	else
 	{
@@ -29,6 +29,8 @@ private:
 	bool				m_bFirstSpawn;
 	unsigned short		m_uiPing;
 	OnFootSyncData		m_oldOnFootSync;
+	EntityId			m_lastVehicleStateVehicleId;
+	VehicleStateData	m_lastVehicleStateSent;
 	/*bool			    m_bAnimating;
 	char*				m_strAnimGroup;
 	char*				m_strAnimSpec;*/
@@ -45,6 +47,7 @@ public:
 	void           SetPlayerControlAdvanced(bool bControl, bool bCamera);
 	void           SendOnFootSync();
 	void           SendInVehicleSync();
+	void           SendVehicleState(CNetworkVehicle * pVehicle);
 	void           SendPassengerSync();
 	void           SendSmallSync();
 	bool           IsPureSyncNeeded();
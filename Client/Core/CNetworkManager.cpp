@@ -238,5 +238,9 @@ void CNetworkManager::Disconnect()
 
 void CNetworkManager::RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, char cOrderingChannel)
 {
+	// Choose the packet channel from the rpc id
+	if(cOrderingChannel == PACKET_CHANNEL_DEFAULT)
+		cOrderingChannel = GetRPCChannel(rpcId);
+
 	m_pNetClient->RPC(rpcId, pBitStream, priority, reliability, cOrderingChannel);
 }
@@ -11,6 +11,7 @@
 
 #include <SharedUtility.h>
 #include <Network/CNetClientInterface.h>
+#include <vector>
 #include "CClientPacketHandler.h"
 #include "CClientRPCHandler.h"
 
@@ -33,12 +34,15 @@ private:
 	bool                   m_bJoinedServer;
 	bool                   m_bJoinedGame;
 	int					   m_iMaxPlayers;
+	std::vector<unsigned char> m_snapshotData;
 
 public:
 	CNetworkManager();
 	~CNetworkManager();
 
 	CNetClientInterface * GetNetClient() { return m_pNetClient; }
+	CClientRPCHandler   * GetRPCHandler() { return m_pClientRPCHandler; }
+	std::vector<unsigned char>& GetSnapshotData() { return m_snapshotData; }
 	String                GetHostName() { return m_sHostName; };
 	void                  SetHostName(String sHostName) { m_sHostName = sHostName; };
 	void				  SetMaxPlayers(int iPlayers) { m_iMaxPlayers = iPlayers; };
@@ -234,55 +234,6 @@ void CRemotePlayer::StoreInVehicleSync(EntityId vehicleId, InVehicleSyncData * s
 		pVehicle->SetHealth(syncPacket->uiHealth);
 		pVehicle->SetPetrolTankHealth(syncPacket->fPetrolHealth);
 
-		// Set their door states
-		for(int i = 0; i <= 5; i++)
-		{
-			if(pVehicle->GetCarDoorAngle(i) != syncPacket->fDoor[i])
-				pVehicle->SetCarDoorAngle(i,false,syncPacket->fDoor[i]);
-		}
-
-		// Check if color set is needed
-		BYTE byteColors[4];
-		pVehicle->GetColors(byteColors[0],byteColors[1],byteColors[2],byteColors[3]);
-		for(int i = 0; i < 4; i++)
-		{
-			if(syncPacket->byteColors[i] != byteColors[i])
-			{
-				// Set their vehicles color
-				pVehicle->SetColors(syncPacket->byteColors[0], syncPacket->byteColors[1], syncPacket->byteColors[2], syncPacket->byteColors[3]);
-				break;
-			}
-			else
-				continue;
-		}
-
-		// Set their vehicles siren state
-		if(pVehicle->GetSirenState() != syncPacket->bSirenState)
-			pVehicle->SetSirenState(syncPacket->bSirenState);
-		
-		// Set their windows
-		for(int i = 0; i <= 3; i++)
-			pVehicle->SetWindowState(i, syncPacket->bWindow[i]);
-
-		// Set their typres
-		for(int i = 0; i <= 5; i++)
-		{
-			if(syncPacket->bTyre[i])
-				Scripting::BurstCarTyre(pVehicle->GetScriptingHandle(),(Scripting::eVehicleTyre)i);
-		}
-
-		// Set their vehicles dirt level
-		if(pVehicle->GetDirtLevel() != syncPacket->fDirtLevel)
-			pVehicle->SetDirtLevel(syncPacket->fDirtLevel);
-
-		// Set their vehicles engine status
-		if(pVehicle->GetEngineState() != syncPacket->bEngineStatus)
-			pVehicle->SetEngineState(syncPacket->bEngineStatus);
-
-		// Set their lights
-		if(pVehicle->GetLightsState() != syncPacket->bLights)
-			pVehicle->SetLightsState(syncPacket->bLights);
-
 		// Lock our health
 		LockHealth(syncPacket->uPlayerHealthArmour >> 16);
 
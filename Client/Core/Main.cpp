@@ -873,7 +873,7 @@ void InternalResetGame(bool bAutoConnect)
 
 	if(g_pClientScriptManager)
 		g_pClientScriptManager->RemoveAll();
-	g_pEvents->clear();
+	g_pEvents->Clear();
 	CLogFile::Printf("Reset clientside scripting stuff");
 
 	SAFE_DELETE(g_pModelManager);
@@ -40,8 +40,9 @@ CNetClient::~CNetClient()
 
 bool CNetClient::Startup()
 {
+	RakNet::SocketDescriptor socketDescriptor;
 	// TODO: Return the real result instead of a boolean
-	return (m_pRakPeer->Startup(1, &RakNet::SocketDescriptor(), 1, THREAD_PRIORITY_NORMAL) == RakNet::RAKNET_STARTED);
+	return (m_pRakPeer->Startup(1, &socketDescriptor, 1, THREAD_PRIORITY_NORMAL) == RakNet::RAKNET_STARTED);
 }
 
 void CNetClient::Shutdown(int iBlockDuration)
@@ -119,14 +120,12 @@ unsigned int CNetClient::RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePack
 {
 	if(IsConnected())
 	{
-		CBitStream bitStream;
-		bitStream.Write((PacketId)PACKET_RPC);
-		bitStream.Write(rpcId);
+		// Pass the rpc header and the data to RakNet as a list so the data doesn't have to be copied behind the header first
+		unsigned char ucHeader[2] = { PACKET_RPC, rpcId };
+		const char * szData[2] = { (char *)ucHeader, (pBitStream ? (char *)pBitStream->GetData() : NULL) };
+		int iLengths[2] = { sizeof(ucHeader), (pBitStream ? (int)pBitStream->GetNumberOfBytesUsed() : 0) };
 
-		if(pBitStream)
-			bitStream.Write((char *)pBitStream->GetData(), pBitStream->GetNumberOfBytesUsed());
-
-		return m_pRakPeer->Send((char *)bitStream.GetData(), bitStream.GetNumberOfBytesUsed(), (PacketPriority)priority, (PacketReliability)reliability, cOrderingChannel, m_serverAddress, false);
+		return m_pRakPeer->SendList(szData, iLengths, 2, (PacketPriority)priority, (PacketReliability)reliability, cOrderingChannel, m_serverAddress, false);
 	}
 
 	return 0;
@@ -19,11 +19,32 @@ CNetServer::CNetServer()
 
 	// Reset the packet handler
 	m_pfnPacketHandler = NULL;
+
+	// Initialize the receive event
+	m_receiveEvent.InitEvent();
+
+	// Reset the received RakNet packet
+	m_pRakPacket = NULL;
+
+	// Reset the packet stats
+	memset(&m_packetStats, 0, sizeof(m_packetStats));
+
+	// Reset the packet replay
+	m_uiReplayTimeStep = 0;
+	m_ulReplayStartTime = 0;
+	m_ulReplayTime = 0;
 }
 
 CNetServer::~CNetServer()
 {
 	SAFE_DELETE(m_pRakPeer);
+
+	// Delete all player sockets
+	for(size_t i = 0; i < m_playerSockets.size(); i++)
+		SAFE_DELETE(m_playerSockets[i]);
+
+	// Close the receive event
+	m_receiveEvent.CloseEvent();
 }
 
 bool CNetServer::Startup(unsigned short usPort, int iMaxPlayers, String strHostAddress)
@@ -33,8 +54,15 @@ bool CNetServer::Startup(unsigned short usPort, int iMaxPlayers, String strHostA
 	bool bStarted = (m_pRakPeer->Startup(iMaxPlayers, &socketDescriptor, 1, THREAD_PRIORITY_NORMAL) == RakNet::RAKNET_STARTED);
 
 	if(bStarted)
+	{
 		m_pRakPeer->SetMaximumIncomingConnections(iMaxPlayers);
 
+		// Create the player socket table, player ids are the RakNet system indices which are always below the max connection count
+		m_playerSockets.resize(iMaxPlayers, NULL);
+		m_playerSocketGenerations.resize(iMaxPlayers, 0);
+		m_bReplayPlayers.resize(iMaxPlayers, false);
+	}
+
 	return bStarted;
 }
 
@@ -47,9 +75,17 @@ void CNetServer::Process()
 {
 	CPacket * pPacket = NULL;
 
+	// Pass the packets which are due from the packet replay to the packet handler
+	if(IsReplayingPackets())
+		ProcessReplay();
+
 	// Loop until we have processed all packets in the packet queue (if any)
 	while(pPacket = Receive())
 	{
+		// Are we capturing packets?
+		if(m_packetCapture.IsOpen())
+			m_packetCapture.AddPacket(pPacket);
+
 		// Do we have a packet handler?
 		if(m_pfnPacketHandler)
 		{
@@ -61,6 +97,59 @@ void CNetServer::Process()
 		// Deallocate the packet memory used
 		DeallocatePacket(pPacket);
 	}
+
+	// Write the packets we captured as one frame
+	if(m_packetCapture.IsOpen())
+		m_packetCapture.EndFrame();
+}
+
+bool CNetServer::WaitForPackets(unsigned int uiTimeout)
+{
+	unsigned long ulEndTime = (SharedUtility::GetTime() + uiTimeout);
+	bool bReplayFrameDue = false;
+
+	// Are we replaying packets?
+	if(IsReplayingPackets())
+	{
+		// Don't wait when replaying with a time step, every process moves the replay on
+		if(m_uiReplayTimeStep > 0)
+			return false;
+
+		// Don't wait past the time the next replayed frame is due
+		unsigned long ulFrameTime = (m_ulReplayStartTime + m_packetReplay.GetFrameTime());
+
+		if(ulFrameTime <= ulEndTime)
+		{
+			ulEndTime = ulFrameTime;
+			bReplayFrameDue = true;
+		}
+	}
+
+	// Loop until we have packets in the packet queue or the timeout has passed
+	while(m_pRakPeer->GetReceiveBufferSize() == 0)
+	{
+		unsigned long ulTime = SharedUtility::GetTime();
+
+		if(ulTime >= ulEndTime)
+			return bReplayFrameDue;
+
+		// Wait for the network thread to receive a message
+		m_receiveEvent.WaitOnEvent((int)(ulEndTime - ulTime));
+
+		// The network thread queues the packet at the end of its update
+		// cycle, so give it a moment before we go back to waiting
+		for(int i = 0; i < 2 && m_pRakPeer->GetReceiveBufferSize() == 0 && SharedUtility::GetTime() < ulEndTime; i++)
+			RakSleep(1);
+	}
+
+	return true;
+}
+
+void CNetServer::OnInternalPacket(RakNet::InternalPacket * internalPacket, unsigned frameNumber, RakNet::SystemAddress remoteSystemAddress, RakNet::TimeMS time, int isSend)
+{
+	// Wake up anyone waiting for packets if we received a message
+	if(!isSend)
+		m_receiveEvent.SetEvent();
 }
 
 void CNetServer::SetPassword(String strPassword)
@@ -85,15 +174,52 @@ unsigned int CNetServer::Send(CBitStream * pBitStream, ePacketPriority priority,
 
 unsigned int CNetServer::RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel)
 {
-	CBitStream bitStream;
+	// Pass the rpc header and the data to RakNet as a list so the data doesn't have to be copied behind the header first
+	unsigned char ucHeader[2] = { PACKET_RPC, rpcId };
+	const char * szData[2] = { (char *)ucHeader, (pBitStream ? (char *)pBitStream->GetData() : NULL) };
+	int iLengths[2] = { sizeof(ucHeader), (pBitStream ? (int)pBitStream->GetNumberOfBytesUsed() : 0) };
+
+	return m_pRakPeer->SendList(szData, iLengths, 2, (PacketPriority)priority, (PacketReliability)reliability, cOrderingChannel, 
+		(playerId == INVALID_ENTITY_ID) ? RakNet::UNASSIGNED_SYSTEM_ADDRESS : m_pRakPeer->GetSystemAddressFromIndex(playerId), bBroadcast);
+}
+
+unsigned int CNetServer::SendToMany(CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel)
+{
+	if(!pBitStream)
+		return 0;
+
+	unsigned int uiSent = 0;
+
+	// Hand the same buffer to RakNet for each player
+	for(unsigned int i = 0; i < uiPlayerCount; i++)
+	{
+		if(pPlayerIds[i] == INVALID_ENTITY_ID)
+			continue;
+
+		if(m_pRakPeer->Send((char *)pBitStream->GetData(), pBitStream->GetNumberOfBytesUsed(), (PacketPriority)priority, (PacketReliability)reliability, 
+			cOrderingChannel, m_pRakPeer->GetSystemAddressFromIndex(pPlayerIds[i]), false) != 0)
+		{
+			uiSent++;
+		}
+	}
+
+	return uiSent;
+}
+
+unsigned int CNetServer::RPCToMany(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel)
+{
+	unsigned int uiDataSize = (pBitStream ? pBitStream->GetNumberOfBytesUsed() : 0);
+
+	// Frame the rpc once
+	CBitStream bitStream(2 + uiDataSize);
 	bitStream.Write((PacketId)PACKET_RPC);
 	bitStream.Write(rpcId);
 
-	if(pBitStream)
-		bitStream.Write((char *)pBitStream->GetData(), pBitStream->GetNumberOfBytesUsed());
+	if(uiDataSize > 0)
+		bitStream.Write((char *)pBitStream->GetData(), uiDataSize);
 
-	return m_pRakPeer->Send((char *)bitStream.GetData(), bitStream.GetNumberOfBytesUsed(), (PacketPriority)priority, (PacketReliability)reliability, cOrderingChannel, 
-		(playerId == INVALID_ENTITY_ID) ? RakNet::UNASSIGNED_SYSTEM_ADDRESS : m_pRakPeer->GetSystemAddressFromIndex(playerId), bBroadcast);
+	// Send the framed rpc to each player
+	return SendToMany(&bitStream, priority, reliability, pPlayerIds, uiPlayerCount, cOrderingChannel);
 }
 
 void CNetServer::RejectKick(EntityId playerId)
@@ -116,8 +242,11 @@ PacketId CNetServer::ProcessPacket(RakNet::SystemAddress systemAddress, PacketId
 	// Get the player id
 	EntityId playerId = (EntityId)systemAddress.systemIndex;
 
+	// Get the player socket
+	CPlayerSocket * pPlayerSocket = GetConnectionPlayerSocket(systemAddress);
+
 	// Is the player not fully connected yet?
-	if(!IsPlayerConnected(playerId))
+	if(!pPlayerSocket)
 	{
 		// Is this a disconnection or connection lost packet?
 		if(packetId == ID_DISCONNECTION_NOTIFICATION || packetId == ID_CONNECTION_LOST)
@@ -139,6 +268,14 @@ PacketId CNetServer::ProcessPacket(RakNet::SystemAddress systemAddress, PacketId
 	{
 	case ID_NEW_INCOMING_CONNECTION: // Request initial data
 		{
+			// Are we replaying packets? (the replayed players use the player ids)
+			if(IsReplayingPackets())
+			{
+				// Reject the players connection
+				RejectKick(playerId);
+				return INVALID_PACKET_ID;
+			}
+
 			// Construct the bit stream
 			CBitStream bitStream;
 
@@ -165,16 +302,22 @@ PacketId CNetServer::ProcessPacket(RakNet::SystemAddress systemAddress, PacketId
 				return INVALID_PACKET_ID;
 			}
 
-			// Verify the network module version
-			if(byteNetworkModuleVersion != NETWORK_MODULE_VERSION)
+			// Verify the network module version and that we are not replaying packets
+			if(byteNetworkModuleVersion != NETWORK_MODULE_VERSION || IsReplayingPackets())
 			{
 				// Reject the players connection
 				RejectKick(playerId);
 				return INVALID_PACKET_ID;
 			}
 
+			// Do we still have a player socket from an old connection which used the same index?
+			CPlayerSocket * pOldPlayerSocket = GetPlayerSocket(playerId);
+
+			if(pOldPlayerSocket)
+				HandleReplacedPlayerSocket(pOldPlayerSocket);
+
 			// Construct the new player socket
-			CPlayerSocket * pPlayerSocket = new CPlayerSocket;
+			pPlayerSocket = new CPlayerSocket;
 
 			// Set the player socket id
 			pPlayerSocket->playerId = playerId;
@@ -185,8 +328,11 @@ PacketId CNetServer::ProcessPacket(RakNet::SystemAddress systemAddress, PacketId
 			// Set the player socket port
 			pPlayerSocket->usPort = ntohs(systemAddress.address.addr4.sin_port);
 
-			// Add the player socket to the player socket list
-			m_playerSocketList.push_back(pPlayerSocket);
+			// Set the player socket generation so it can be told apart from older sockets with the same id
+			pPlayerSocket->uiGeneration = ++m_playerSocketGenerations[playerId];
+
+			// Add the player socket to the player socket table
+			m_playerSockets[playerId] = pPlayerSocket;
 
 			// Reset the bit stream for reuse
 			bitStream.Reset();
@@ -226,8 +372,6 @@ CPacket * CNetServer::Receive()
 	// Did we get a packet?
 	if(pRakPacket)
 	{
-		CPacket * pPacket = NULL;
-
 		// Get the data
 		unsigned char * ucData = (pRakPacket->data + sizeof(PacketId));
 
@@ -240,11 +384,11 @@ CPacket * CNetServer::Receive()
 		// Is this a valid packet?
 		if(packetId != INVALID_PACKET_ID)
 		{
-			// Create the new packet
-			pPacket = new CPacket;
+			// Packets are handled one at a time so we can reuse the same packet
+			CPacket * pPacket = &m_packet;
 
 			// Set the packet player socket
-			pPacket->pPlayerSocket = GetPlayerSocket((EntityId)pRakPacket->systemAddress.systemIndex);
+			pPacket->pPlayerSocket = GetConnectionPlayerSocket(pRakPacket->systemAddress);
 
 			// Set the packet id
 			pPacket->packetId = packetId;
@@ -252,25 +396,19 @@ CPacket * CNetServer::Receive()
 			// Set the packet length
 			pPacket->uiLength = uiLength;
 
-			// Do we have any packet data?
-			if(uiLength > 0)
-			{
-				// Allocate and set the packet data
-				pPacket->ucData = (unsigned char *)malloc(uiLength);
+			// Point the packet data at the RakNet packet data, the RakNet
+			// packet is kept until the packet is deallocated
+			pPacket->ucData = ((uiLength > 0) ? ucData : NULL);
+			m_pRakPacket = pRakPacket;
 
-				// Copy the packet data
-				memcpy(pPacket->ucData, ucData, uiLength);
-			}
-			else
-			{
-				// Reset the packet data pointer
-				pPacket->ucData = NULL;
-			}
+			// Increment the received packet count
+			m_packetStats.uiPacketsReceived++;
+			return pPacket;
 		}
 
 		// Delete the RakNet packet
 		m_pRakPeer->DeallocatePacket(pRakPacket);
-		return pPacket;
+		return NULL;
 	}
 
 	// No packets in the queue
@@ -284,21 +422,14 @@ void CNetServer::DeallocatePacket(CPacket * pPacket)
 	// Check if we have a disconnection packet
 	if(pPacket->packetId == PACKET_DISCONNECTED || pPacket->packetId == PACKET_LOST_CONNECTION)
 	{
-		// Get the player socket
-		CPlayerSocket * pPlayerSocket = pPacket->pPlayerSocket;
-
-		// Delete the player socket
-		SAFE_DELETE(pPlayerSocket);
-
-		// Remove the player socket from the player socket list
-		m_playerSocketList.remove(pPlayerSocket);
+		// Remove the player socket
+		if(pPacket->pPlayerSocket)
+			RemovePlayerSocket(pPacket->pPlayerSocket);
 	}
 
-	// Free the packet data
-	SAFE_FREE(pPacket->ucData);
-
-	// Delete the packet
-	SAFE_DELETE(pPacket);
+	// Delete the RakNet packet the packet data belongs to
+	m_pRakPeer->DeallocatePacket(m_pRakPacket);
+	m_pRakPacket = NULL;
 }
 
 const char * CNetServer::GetPlayerIp(EntityId playerId)
@@ -321,21 +452,81 @@ void CNetServer::KickPlayer(EntityId playerId, bool bSendDisconnectionNotificati
 	m_pRakPeer->CloseConnection(m_pRakPeer->GetSystemAddressFromIndex(playerId), bSendDisconnectionNotification, 0, (PacketPriority)disconnectionPacketPriority);
 }
 
+void CNetServer::RemovePlayerSocket(CPlayerSocket * pPlayerSocket)
+{
+	EntityId playerId = pPlayerSocket->playerId;
+
+	// Is this still the current player socket for this player id?
+	if(playerId < m_playerSockets.size() && m_playerSockets[playerId] == pPlayerSocket && 
+		pPlayerSocket->uiGeneration == m_playerSocketGenerations[playerId])
+	{
+		m_playerSockets[playerId] = NULL;
+	}
+
+	// Delete the player socket
+	delete pPlayerSocket;
+}
+
 CPlayerSocket * CNetServer::GetPlayerSocket(EntityId playerId)
 {
-	// Loop through the player socket list
-	for(std::list<CPlayerSocket *>::iterator iter = m_playerSocketList.begin(); iter != m_playerSocketList.end(); iter++)
+	// Is the player id invalid?
+	if(playerId >= m_playerSockets.size())
+		return NULL;
+
+	return m_playerSockets[playerId];
+}
+
+CPlayerSocket * CNetServer::GetPlayerSocket(EntityId playerId, unsigned int uiGeneration)
+{
+	CPlayerSocket * pPlayerSocket = GetPlayerSocket(playerId);
+
+	// Has the player id been reused since the generation was taken?
+	if(pPlayerSocket && pPlayerSocket->uiGeneration != uiGeneration)
+		return NULL;
+
+	return pPlayerSocket;
+}
+
+void CNetServer::HandleReplacedPlayerSocket(CPlayerSocket * pPlayerSocket)
+{
+	// We never got the disconnection of the old connection so tell the packet handler it was lost
+	CPacket packet;
+	packet.pPlayerSocket = pPlayerSocket;
+	packet.packetId = PACKET_LOST_CONNECTION;
+	packet.uiLength = 0;
+	packet.ucData = NULL;
+
+	// Are we capturing packets?
+	if(m_packetCapture.IsOpen())
+		m_packetCapture.AddPacket(&packet);
+
+	// Pass it to the packet handler
+	if(m_pfnPacketHandler)
+		m_pfnPacketHandler(&packet);
+
+	// Remove the player socket
+	RemovePlayerSocket(pPlayerSocket);
+}
+
+CPlayerSocket * CNetServer::GetConnectionPlayerSocket(RakNet::SystemAddress systemAddress)
+{
+	EntityId playerId = (EntityId)systemAddress.systemIndex;
+
+	// Is the player id invalid or used by a replayed player?
+	if(playerId >= m_playerSockets.size() || m_bReplayPlayers[playerId])
+		return NULL;
+
+	CPlayerSocket * pPlayerSocket = m_playerSockets[playerId];
+
+	// Is the player socket from an older connection which used the same index? (a stale id)
+	if(pPlayerSocket && (pPlayerSocket->uiGeneration != m_playerSocketGenerations[playerId] || 
+		pPlayerSocket->ulBinaryAddress != systemAddress.address.addr4.sin_addr.s_addr || 
+		pPlayerSocket->usPort != ntohs(systemAddress.address.addr4.sin_port)))
 	{
-		// Is this the player socket we are looking for?
-		if((*iter)->playerId == playerId)
-		{
-			// Return the player socket
-			return (*iter);
-			break;
-		}
+		return NULL;
 	}
 
-	return NULL;
+	return pPlayerSocket;
 }
 
 bool CNetServer::IsPlayerConnected(EntityId playerId)
@@ -362,3 +553,171 @@ int CNetServer::GetPlayerAveragePing(EntityId playerId)
 {
 	return m_pRakPeer->GetAveragePing(m_pRakPeer->GetSystemAddressFromIndex(playerId));
 }
+
+void CNetServer::GetPacketStats(NetPacketStats * pStats)
+{
+	m_packetStats.uiPacketsCaptured = m_packetCapture.GetPacketCount();
+	memcpy(pStats, &m_packetStats, sizeof(NetPacketStats));
+}
+
+bool CNetServer::GetPlayerNetStats(EntityId playerId, CNetStats * pNetStats)
+{
+	// Get the RakNet statistics of the players connection
+	RakNet::RakNetStatistics rakStats;
+
+	if(!m_pRakPeer->GetStatistics(m_pRakPeer->GetSystemAddressFromIndex(playerId), &rakStats))
+		return false;
+
+	memcpy(pNetStats->ulValueOverLastSecond, rakStats.valueOverLastSecond, (sizeof(NetStat_t) * NET_STAT_METRICS_COUNT));
+	memcpy(pNetStats->ulRunningTotal, rakStats.runningTotal, (sizeof(NetStat_t) * NET_STAT_METRICS_COUNT));
+	pNetStats->ulConnectionStartTime = rakStats.connectionStartTime;
+	pNetStats->bIsLimitedByCongestionControl = rakStats.isLimitedByCongestionControl;
+	pNetStats->ulBPSLimitByCongestionControl = rakStats.BPSLimitByCongestionControl;
+	pNetStats->bIsLimitedByOutgoingBandwidthLimit = rakStats.isLimitedByOutgoingBandwidthLimit;
+	pNetStats->ulBPSLimitByOutgoingBandwidthLimit = rakStats.BPSLimitByOutgoingBandwidthLimit;
+	memcpy(pNetStats->uiMessageInSendBuffer, rakStats.messageInSendBuffer, (sizeof(unsigned int) * PRIORITY_COUNT));
+	memcpy(pNetStats->dBytesInSendBuffer, rakStats.bytesInSendBuffer, (sizeof(double) * PRIORITY_COUNT));
+	pNetStats->uiMessagesInResendBuffer = rakStats.messagesInResendBuffer;
+	pNetStats->ulBytesInResendBuffer = rakStats.bytesInResendBuffer;
+	pNetStats->fPacketlossLastSecond = rakStats.packetlossLastSecond;
+	pNetStats->fPacketlossTotal = rakStats.packetlossTotal;
+	return true;
+}
+
+bool CNetServer::StartPacketCapture(String strFileName)
+{
+	return m_packetCapture.Open(strFileName.Get());
+}
+
+void CNetServer::StopPacketCapture()
+{
+	m_packetCapture.Close();
+}
+
+bool CNetServer::StartPacketReplay(String strFileName, unsigned int uiTimeStep)
+{
+	// Stop the current replay (if any)
+	StopPacketReplay();
+
+	// Are any players connected? (the replayed players use the same player ids)
+	for(EntityId playerId = 0; playerId < m_playerSockets.size(); playerId++)
+	{
+		if(m_playerSockets[playerId])
+			return false;
+	}
+
+	// Open the capture file
+	if(!m_packetReplay.Open(strFileName.Get()))
+		return false;
+
+	// Start the replay at the first frame so we don't wait for the time before it
+	m_uiReplayTimeStep = uiTimeStep;
+	m_ulReplayTime = (m_packetReplay.GetFrameTime() - uiTimeStep);
+	m_ulReplayStartTime = (SharedUtility::GetTime() - m_packetReplay.GetFrameTime());
+	return true;
+}
+
+void CNetServer::StopPacketReplay()
+{
+	m_packetReplay.Close();
+
+	// Disconnect the replayed players which are still connected
+	for(EntityId playerId = 0; playerId < m_bReplayPlayers.size(); playerId++)
+	{
+		if(m_bReplayPlayers[playerId])
+		{
+			CPlayerSocket * pPlayerSocket = GetPlayerSocket(playerId);
+
+			if(pPlayerSocket)
+				HandleReplayPacket(pPlayerSocket, PACKET_DISCONNECTED, NULL, 0);
+
+			m_bReplayPlayers[playerId] = false;
+		}
+	}
+}
+
+void CNetServer::HandleReplayPacket(CPlayerSocket * pPlayerSocket, PacketId packetId, unsigned char * ucData, unsigned int uiLength)
+{
+	// Construct the packet
+	CPacket packet;
+	packet.pPlayerSocket = pPlayerSocket;
+	packet.packetId = packetId;
+	packet.uiLength = uiLength;
+	packet.ucData = ucData;
+
+	// Pass it to the packet handler
+	if(m_pfnPacketHandler)
+		m_pfnPacketHandler(&packet);
+
+	m_packetStats.uiPacketsReplayed++;
+
+	// Remove the player socket of disconnected players
+	if(packetId == PACKET_DISCONNECTED || packetId == PACKET_LOST_CONNECTION)
+	{
+		m_bReplayPlayers[pPlayerSocket->playerId] = false;
+		RemovePlayerSocket(pPlayerSocket);
+	}
+}
+
+void CNetServer::ProcessReplay()
+{
+	// Move the replay time on
+	if(m_uiReplayTimeStep > 0)
+		m_ulReplayTime += m_uiReplayTimeStep;
+	else
+		m_ulReplayTime = (SharedUtility::GetTime() - m_ulReplayStartTime);
+
+	// Pass the packets of all frames which are due to the packet handler
+	ReplayPacket replayPacket;
+
+	while(m_packetReplay.HasFrame() && m_packetReplay.GetFrameTime() <= m_ulReplayTime)
+	{
+		while(m_packetReplay.ReadPacket(&replayPacket))
+		{
+			// Is the player id invalid?
+			if(replayPacket.playerId >= m_playerSockets.size())
+				continue;
+
+			// Get the player socket
+			CPlayerSocket * pPlayerSocket = GetPlayerSocket(replayPacket.playerId);
+
+			// Is this a new connection?
+			if(replayPacket.packetId == PACKET_NEW_CONNECTION)
+			{
+				// Do we still have a player socket from an old replayed connection which used the same index?
+				if(pPlayerSocket)
+				{
+					// Is the player socket not from the replay?
+					if(!m_bReplayPlayers[replayPacket.playerId])
+						continue;
+
+					HandleReplayPacket(pPlayerSocket, PACKET_DISCONNECTED, NULL, 0);
+				}
+
+				// Recreate the player socket like a real connection
+				pPlayerSocket = new CPlayerSocket;
+				pPlayerSocket->playerId = replayPacket.playerId;
+				pPlayerSocket->ulBinaryAddress = replayPacket.ulBinaryAddress;
+				pPlayerSocket->usPort = replayPacket.usPort;
+				pPlayerSocket->strSerial = replayPacket.strSerial;
+				pPlayerSocket->uiGeneration = ++m_playerSocketGenerations[replayPacket.playerId];
+				m_playerSockets[replayPacket.playerId] = pPlayerSocket;
+				m_bReplayPlayers[replayPacket.playerId] = true;
+			}
+			else if(!pPlayerSocket)
+			{
+				// The player is not connected
+				continue;
+			}
+
+			HandleReplayPacket(pPlayerSocket, replayPacket.packetId, replayPacket.ucData, replayPacket.uiLength);
+		}
+
+		// Read the next frame
+		m_packetReplay.ReadFrame();
+	}
+
+	// Have we reached the end of the capture file?
+	if(!m_packetReplay.HasFrame())
+		StopPacketReplay();
+}
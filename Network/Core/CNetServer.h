@@ -10,20 +10,40 @@
 #pragma once
 
 #include <StdInc.h>
-#include <list>
+#include <vector>
 
 class CNetServer : CRakNetInterface, public CNetServerInterface
 {
 private:
-	RakNet::RakPeerInterface * m_pRakPeer;
-	String                     m_strPassword;
-	PacketHandler_t            m_pfnPacketHandler;
-	std::list<CPlayerSocket *> m_playerSocketList;
+	RakNet::RakPeerInterface   * m_pRakPeer;
+	String                       m_strPassword;
+	PacketHandler_t              m_pfnPacketHandler;
+	std::vector<CPlayerSocket *> m_playerSockets;
+	std::vector<unsigned int>    m_playerSocketGenerations;
+	std::vector<bool>            m_bReplayPlayers;
+	RakNet::SignaledEvent        m_receiveEvent;
+	CPacket                      m_packet;
+	RakNet::Packet             * m_pRakPacket;
+	NetPacketStats               m_packetStats;
+	CPacketCapture               m_packetCapture;
+	CPacketReplay                m_packetReplay;
+	unsigned int                 m_uiReplayTimeStep;
+	unsigned long                m_ulReplayStartTime;
+	unsigned long                m_ulReplayTime;
 
+	void            RemovePlayerSocket(CPlayerSocket * pPlayerSocket);
+	void            HandleReplacedPlayerSocket(CPlayerSocket * pPlayerSocket);
+	CPlayerSocket * GetConnectionPlayerSocket(RakNet::SystemAddress systemAddress);
 	PacketId        ProcessPacket(RakNet::SystemAddress systemAddress, PacketId packetId, unsigned char * ucData, int iLength);
 	CPacket *       Receive();
 	void            DeallocatePacket(CPacket * pPacket);
 	void            RejectKick(EntityId playerId);
+	unsigned long   GetReplayTime();
+	void            HandleReplayPacket(CPlayerSocket * pPlayerSocket, PacketId packetId, unsigned char * ucData, unsigned int uiLength);
+	void            ProcessReplay();
+
+	// CRakNetInterface
+	void            OnInternalPacket(RakNet::InternalPacket * internalPacket, unsigned frameNumber, RakNet::SystemAddress remoteSystemAddress, RakNet::TimeMS time, int isSend);
 
 public:
 	CNetServer();
@@ -32,10 +52,13 @@ public:
 	bool            Startup(unsigned short usPort, int iMaxPlayers, String strHostAddress = "");
 	void            Shutdown(int iBlockDuration);
 	void            Process();
+	bool            WaitForPackets(unsigned int uiTimeout);
 	void            SetPassword(String strPassword);
 	const char    * GetPassword();
 	unsigned int    Send(CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
 	unsigned int    RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	unsigned int    SendToMany(CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	unsigned int    RPCToMany(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
 	const char    * GetPlayerIp(EntityId playerId);
 	unsigned short  GetPlayerPort(EntityId playerId);
 	void            SetPacketHandler(PacketHandler_t pfnPacketHandler) { m_pfnPacketHandler = pfnPacketHandler; }
@@ -43,9 +66,17 @@ public:
 	const char    * GetPlayerSerial(EntityId playerId);
 	void            KickPlayer(EntityId playerId, bool bSendDisconnectionNotification = true, ePacketPriority disconnectionPacketPriority = PRIORITY_LOW);
 	CPlayerSocket * GetPlayerSocket(EntityId playerId);
+	CPlayerSocket * GetPlayerSocket(EntityId playerId, unsigned int uiGeneration);
 	bool            IsPlayerConnected(EntityId playerId);
 	void            BanIp(String strIpAddress, unsigned int uiTimeMilliseconds);
 	void            UnbanIp(String strIpAddress);
 	int             GetPlayerLastPing(EntityId playerId);
 	int             GetPlayerAveragePing(EntityId playerId);
+	void            GetPacketStats(NetPacketStats * pStats);
+	bool            GetPlayerNetStats(EntityId playerId, CNetStats * pNetStats);
+	bool            StartPacketCapture(String strFileName);
+	void            StopPacketCapture();
+	bool            StartPacketReplay(String strFileName, unsigned int uiTimeStep);
+	void            StopPacketReplay();
+	bool            IsReplayingPackets() { return m_packetReplay.HasFrame(); }
 };
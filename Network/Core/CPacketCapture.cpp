@@ -0,0 +1,113 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CPacketCapture.cpp
+// Project: Network.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include <StdInc.h>
+
+CPacketCapture::CPacketCapture()
+{
+	m_pFile = NULL;
+	m_ulStartTime = 0;
+	m_usFramePackets = 0;
+	m_uiPacketCount = 0;
+}
+
+CPacketCapture::~CPacketCapture()
+{
+	Close();
+}
+
+bool CPacketCapture::Open(const char * szFileName)
+{
+	// Close the current capture file (if any)
+	Close();
+
+	// Open the capture file
+	m_pFile = fopen(szFileName, "wb");
+
+	if(!m_pFile)
+		return false;
+
+	// Write the header
+	unsigned char ucVersions[2] = { PACKET_CAPTURE_VERSION, NETWORK_VERSION };
+	fwrite(PACKET_CAPTURE_MAGIC, 1, 4, m_pFile);
+	fwrite(ucVersions, 1, sizeof(ucVersions), m_pFile);
+
+	// Reset the capture
+	m_ulStartTime = SharedUtility::GetTime();
+	m_frame.clear();
+	m_usFramePackets = 0;
+	m_uiPacketCount = 0;
+	return true;
+}
+
+void CPacketCapture::Close()
+{
+	if(m_pFile)
+	{
+		// Write anything still buffered
+		EndFrame();
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+}
+
+void CPacketCapture::WriteFrameData(const void * pData, unsigned int uiSize)
+{
+	m_frame.insert(m_frame.end(), (const unsigned char *)pData, ((const unsigned char *)pData + uiSize));
+}
+
+void CPacketCapture::AddPacket(CPacket * pPacket)
+{
+	// Is the frame full? (the packet count has to fit in the frame header)
+	if(m_usFramePackets == 0xFFFF)
+		EndFrame();
+
+	// Write the packet header and data to the frame
+	EntityId playerId = (pPacket->pPlayerSocket ? pPacket->pPlayerSocket->playerId : INVALID_ENTITY_ID);
+	WriteFrameData(&playerId, sizeof(EntityId));
+	WriteFrameData(&pPacket->packetId, sizeof(PacketId));
+	WriteFrameData(&pPacket->uiLength, sizeof(unsigned int));
+
+	if(pPacket->uiLength > 0)
+		WriteFrameData(pPacket->ucData, pPacket->uiLength);
+
+	// Write the player socket of new connections so they can be recreated on replay
+	if(pPacket->packetId == PACKET_NEW_CONNECTION && pPacket->pPlayerSocket)
+	{
+		unsigned int uiBinaryAddress = (unsigned int)pPacket->pPlayerSocket->ulBinaryAddress;
+		unsigned int uiSerialLength = pPacket->pPlayerSocket->strSerial.GetLength();
+		unsigned char ucSerialLength = (unsigned char)((uiSerialLength > 0xFF) ? 0xFF : uiSerialLength);
+		WriteFrameData(&uiBinaryAddress, sizeof(unsigned int));
+		WriteFrameData(&pPacket->pPlayerSocket->usPort, sizeof(unsigned short));
+		WriteFrameData(&ucSerialLength, sizeof(unsigned char));
+		WriteFrameData(pPacket->pPlayerSocket->strSerial.Get(), ucSerialLength);
+	}
+
+	m_usFramePackets++;
+	m_uiPacketCount++;
+}
+
+void CPacketCapture::EndFrame()
+{
+	// Did we capture any packets in this frame?
+	if(!m_pFile || m_usFramePackets == 0)
+		return;
+
+	// Write the frame header and the frame in one go
+	unsigned int uiTime = (unsigned int)(SharedUtility::GetTime() - m_ulStartTime);
+	unsigned int uiSize = (unsigned int)m_frame.size();
+	fwrite(&uiTime, sizeof(unsigned int), 1, m_pFile);
+	fwrite(&m_usFramePackets, sizeof(unsigned short), 1, m_pFile);
+	fwrite(&uiSize, sizeof(unsigned int), 1, m_pFile);
+	fwrite(&m_frame[0], 1, uiSize, m_pFile);
+
+	// Reset the frame
+	m_frame.clear();
+	m_usFramePackets = 0;
+}
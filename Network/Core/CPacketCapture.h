@@ -0,0 +1,50 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CPacketCapture.h
+// Project: Network.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include <StdInc.h>
+#include <stdio.h>
+#include <vector>
+
+// Capture file header: magic, format version and network version
+#define PACKET_CAPTURE_MAGIC "IVPC"
+#define PACKET_CAPTURE_VERSION 1
+
+// Capture file layout (all values little endian):
+//   Header: char[4] magic, unsigned char format version, unsigned char network version
+//   Frame (the packets of one CNetServer::Process call):
+//     unsigned int time (ms since the capture started), unsigned short packet count, unsigned int size
+//     Packet: EntityId player id, PacketId packet id, unsigned int length, data
+//       PACKET_NEW_CONNECTION packets are followed by the player socket:
+//       unsigned int binary address, unsigned short port, unsigned char serial length, serial
+
+// Writes the packets passed to the packet handler to a capture file
+class CPacketCapture
+{
+private:
+	FILE                     * m_pFile;
+	unsigned long              m_ulStartTime;
+	std::vector<unsigned char> m_frame;
+	unsigned short             m_usFramePackets;
+	unsigned int               m_uiPacketCount;
+
+	void                       WriteFrameData(const void * pData, unsigned int uiSize);
+
+public:
+	CPacketCapture();
+	~CPacketCapture();
+
+	bool                       Open(const char * szFileName);
+	void                       Close();
+	bool                       IsOpen() { return (m_pFile != NULL); }
+	void                       AddPacket(CPacket * pPacket);
+	void                       EndFrame();
+	unsigned int               GetPacketCount() { return m_uiPacketCount; }
+};
@@ -0,0 +1,148 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CPacketReplay.cpp
+// Project: Network.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include <StdInc.h>
+
+CPacketReplay::CPacketReplay()
+{
+	m_pFile = NULL;
+	m_uiFrameSize = 0;
+	m_uiFrameTime = 0;
+	m_usFramePackets = 0;
+	m_usNextPacket = 0;
+	m_uiFrameOffset = 0;
+	m_bHasFrame = false;
+}
+
+CPacketReplay::~CPacketReplay()
+{
+	Close();
+}
+
+bool CPacketReplay::Open(const char * szFileName)
+{
+	// Close the current capture file (if any)
+	Close();
+
+	// Open the capture file
+	m_pFile = fopen(szFileName, "rb");
+
+	if(!m_pFile)
+		return false;
+
+	// Read and verify the header
+	char szMagic[4];
+	unsigned char ucVersions[2];
+
+	if(fread(szMagic, 1, 4, m_pFile) != 4 || memcmp(szMagic, PACKET_CAPTURE_MAGIC, 4) ||
+		fread(ucVersions, 1, sizeof(ucVersions), m_pFile) != sizeof(ucVersions) ||
+		ucVersions[0] != PACKET_CAPTURE_VERSION || ucVersions[1] != NETWORK_VERSION)
+	{
+		Close();
+		return false;
+	}
+
+	// Read the first frame
+	return ReadFrame();
+}
+
+void CPacketReplay::Close()
+{
+	if(m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+
+	m_bHasFrame = false;
+}
+
+bool CPacketReplay::ReadFrame()
+{
+	m_bHasFrame = false;
+
+	if(!m_pFile)
+		return false;
+
+	// Read the frame header
+	unsigned int uiSize;
+
+	if(fread(&m_uiFrameTime, sizeof(unsigned int), 1, m_pFile) != 1 ||
+		fread(&m_usFramePackets, sizeof(unsigned short), 1, m_pFile) != 1 ||
+		fread(&uiSize, sizeof(unsigned int), 1, m_pFile) != 1)
+	{
+		return false;
+	}
+
+	// Is the frame size implausible?
+	if(uiSize > PACKET_REPLAY_MAX_FRAME_SIZE)
+		return false;
+
+	// Read the frame (the frame buffer only ever grows so it isn't reallocated for every frame)
+	if(m_frame.size() < uiSize)
+		m_frame.resize(uiSize);
+
+	if(uiSize > 0 && fread(&m_frame[0], 1, uiSize, m_pFile) != uiSize)
+		return false;
+
+	m_uiFrameSize = uiSize;
+	m_usNextPacket = 0;
+	m_uiFrameOffset = 0;
+	m_bHasFrame = true;
+	return true;
+}
+
+bool CPacketReplay::ReadFrameData(void * pData, unsigned int uiSize)
+{
+	if(uiSize > (m_uiFrameSize - m_uiFrameOffset))
+		return false;
+
+	memcpy(pData, &m_frame[m_uiFrameOffset], uiSize);
+	m_uiFrameOffset += uiSize;
+	return true;
+}
+
+bool CPacketReplay::ReadPacket(ReplayPacket * pPacket)
+{
+	// Do we have any packets left in this frame?
+	if(!m_bHasFrame || m_usNextPacket >= m_usFramePackets)
+		return false;
+
+	// Read the packet header
+	if(!ReadFrameData(&pPacket->playerId, sizeof(EntityId)) || !ReadFrameData(&pPacket->packetId, sizeof(PacketId)) ||
+		!ReadFrameData(&pPacket->uiLength, sizeof(unsigned int)) || pPacket->uiLength > (m_uiFrameSize - m_uiFrameOffset))
+	{
+		return false;
+	}
+
+	// Point the packet data at the frame
+	pPacket->ucData = ((pPacket->uiLength > 0) ? &m_frame[m_uiFrameOffset] : NULL);
+	m_uiFrameOffset += pPacket->uiLength;
+
+	// Read the player socket of new connections
+	if(pPacket->packetId == PACKET_NEW_CONNECTION)
+	{
+		unsigned int uiBinaryAddress;
+		unsigned char ucSerialLength;
+		char szSerial[256];
+
+		if(!ReadFrameData(&uiBinaryAddress, sizeof(unsigned int)) || !ReadFrameData(&pPacket->usPort, sizeof(unsigned short)) ||
+			!ReadFrameData(&ucSerialLength, sizeof(unsigned char)) || !ReadFrameData(szSerial, ucSerialLength))
+		{
+			return false;
+		}
+
+		szSerial[ucSerialLength] = '\0';
+		pPacket->ulBinaryAddress = uiBinaryAddress;
+		pPacket->strSerial.Set(szSerial);
+	}
+
+	m_usNextPacket++;
+	return true;
+}
@@ -0,0 +1,56 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CPacketReplay.h
+// Project: Network.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include <StdInc.h>
+#include <stdio.h>
+#include <vector>
+
+// Frames larger than this are treated as a corrupt capture file
+#define PACKET_REPLAY_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+// Packet read from a capture file
+struct ReplayPacket
+{
+	EntityId        playerId;
+	PacketId        packetId;
+	unsigned int    uiLength;
+	unsigned char * ucData;
+	unsigned long   ulBinaryAddress;
+	unsigned short  usPort;
+	String          strSerial;
+};
+
+// Reads the frames of a capture file written by CPacketCapture
+class CPacketReplay
+{
+private:
+	FILE                     * m_pFile;
+	std::vector<unsigned char> m_frame;
+	unsigned int               m_uiFrameSize;
+	unsigned int               m_uiFrameTime;
+	unsigned short             m_usFramePackets;
+	unsigned short             m_usNextPacket;
+	unsigned int               m_uiFrameOffset;
+	bool                       m_bHasFrame;
+
+	bool                       ReadFrameData(void * pData, unsigned int uiSize);
+
+public:
+	CPacketReplay();
+	~CPacketReplay();
+
+	bool                       Open(const char * szFileName);
+	void                       Close();
+	bool                       ReadFrame();
+	bool                       HasFrame() { return m_bHasFrame; }
+	unsigned int               GetFrameTime() { return m_uiFrameTime; }
+	bool                       ReadPacket(ReplayPacket * pPacket);
+};
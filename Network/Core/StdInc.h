@@ -12,6 +12,7 @@
 #include "RakNet/RakPeer.h"
 #include "RakNet/BitStream.h"
 #include "RakNet/MessageIdentifiers.h"
+#include "RakNet/RakSleep.h"
 
 // Shared
 #include <Common.h>
@@ -31,5 +32,7 @@
 
 // Project
 #include "CRakNetInterface.h"
+#include "CPacketCapture.h"
+#include "CPacketReplay.h"
 #include "CNetServer.h"
 #include "CNetClient.h"
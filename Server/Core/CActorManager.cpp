@@ -14,11 +14,13 @@
 #include "CModuleManager.h"
 #include "CVehicle.h"
 #include "CVehicleManager.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CEvents * g_pEvents;
 extern CModuleManager * g_pModuleManager;
 extern CVehicleManager * g_pVehicleManager;
+extern CWorldSnapshot * g_pWorldSnapshot;
 
 CActorManager::CActorManager()
 {
@@ -81,6 +83,7 @@ EntityId CActorManager::Create(int iModelId, CVector3 vecPosition, float fHeadin
 			memcpy(&m_Actors[x].vecPosition, &vecPosition, sizeof(CVector3));
 			m_Actors[x].fHeading = fHeading;
 			m_bActive[x] = true;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 			CSquirrelArguments pArguments;
 			pArguments.push(x);
 			g_pEvents->Call("actorCreate", &pArguments);
@@ -109,6 +112,7 @@ void CActorManager::Delete(EntityId actorId)
 	bsSend.Write(actorId);
 	g_pNetworkManager->RPC(RPC_DeleteActor, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
 	m_bActive[actorId] = false;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 }
 
 void CActorManager::SetPosition(EntityId actorId, CVector3 vecPosition)
@@ -116,6 +120,7 @@ void CActorManager::SetPosition(EntityId actorId, CVector3 vecPosition)
 	if(m_bActive[actorId])
 	{
 		memcpy(&m_Actors[actorId].vecPosition, &vecPosition, sizeof(CVector3));
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 		CBitStream bsSend;
 		bsSend.Write(actorId);
 		bsSend.Write(vecPosition);
@@ -128,6 +133,7 @@ void CActorManager::SetColor(EntityId actorId, unsigned int iColor)
 	if(m_bActive[actorId])
 	{
 		m_Actors[actorId].iColor = iColor;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 		CBitStream bsSend;
 		bsSend.Write(actorId);
 		bsSend.Write((DWORD)iColor);
@@ -148,6 +154,7 @@ void CActorManager::SetHeading(EntityId actorId, float fHeading)
 	if(m_bActive[actorId])
 	{
 		m_Actors[actorId].fHeading = fHeading;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 		CBitStream bsSend;
 		bsSend.Write(actorId);
 		bsSend.Write(fHeading);
@@ -163,6 +170,7 @@ void CActorManager::SetActorName(EntityId actorId, String strName)
 		if(strName.GetLength() > 2)
 		{
 			m_Actors[actorId].strName = strName;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 			CBitStream bsSend;
 			bsSend.Write(actorId);
 			bsSend.Write(strName);
@@ -236,6 +244,7 @@ bool CActorManager::DoesExist(EntityId actorId)
 bool CActorManager::ToggleNametag(EntityId actorId, bool bShow)
 {
 	m_Actors[actorId].bTogglename = bShow;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 	CBitStream bsSend;
 	bsSend.Write(actorId);
 	bsSend.Write(bShow);
@@ -248,6 +257,7 @@ bool CActorManager::ToggleBlip(EntityId actorId, bool bShow)
 	if(m_Actors[actorId].bBlip != bShow)
 	{
 		m_Actors[actorId].bBlip = bShow;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 		CBitStream bsSend;
 		bsSend.Write(actorId);
 		bsSend.Write(bShow);
@@ -259,6 +269,7 @@ bool CActorManager::ToggleBlip(EntityId actorId, bool bShow)
 bool CActorManager::ToggleFrozen(EntityId actorId, bool bFrozen)
 {
 	m_Actors[actorId].bFrozen = bFrozen;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 	CBitStream bsSend;
 	bsSend.Write(actorId);
 	bsSend.Write(bFrozen);
@@ -269,6 +280,7 @@ bool CActorManager::ToggleFrozen(EntityId actorId, bool bFrozen)
 bool CActorManager::ToggleHelmet(EntityId actorId, bool bHelmet)
 {
 	m_Actors[actorId].bHelmet = bHelmet;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 	CBitStream bsSend;
 	bsSend.Write(actorId);
 	bsSend.Write(bHelmet);
@@ -291,6 +303,7 @@ void CActorManager::WarpIntoVehicle(EntityId actorId, EntityId vehicleId, int iS
 		m_Actors[actorId].bStateincar = true;
 		m_Actors[actorId].vehicleId = vehicleId;
 		m_Actors[actorId].iSeat = iSeatid;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 
 		CBitStream bsSend;
 		bsSend.Write(actorId);
@@ -342,11 +355,13 @@ bool CActorManager::UpdateDrivePos(EntityId actorId, CVector3 vecDrivePos,CVecto
 				pVehicle->SetRotationSave(vecDriveRot);
 			}
 			m_Actors[actorId].bDrivingAutomatic = true;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 			return true;
 		}
 		else if(bStop)
 		{
 			m_Actors[actorId].bDrivingAutomatic = false;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_ACTORS);
 			CBitStream bsSend;
 			bsSend.Write(actorId);
 			g_pNetworkManager->RPC(RPC_ScriptingStopActorDriving, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
@@ -0,0 +1,63 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CAllocationCounter.cpp
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CAllocationCounter.h"
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+#include <stdlib.h>
+#include <new>
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+static volatile long g_lAllocationCount = 0;
+
+unsigned int CAllocationCounter::GetCount()
+{
+	return (unsigned int)g_lAllocationCount;
+}
+
+static void * CountedAlloc(size_t sSize)
+{
+	// Allocations can happen on any thread
+#ifdef WIN32
+	InterlockedIncrement(&g_lAllocationCount);
+#else
+	__sync_fetch_and_add(&g_lAllocationCount, 1);
+#endif
+
+	void * pMemory = malloc(sSize ? sSize : 1);
+
+	if(!pMemory)
+		throw std::bad_alloc();
+
+	return pMemory;
+}
+
+void * operator new(size_t sSize)
+{
+	return CountedAlloc(sSize);
+}
+
+void * operator new[](size_t sSize)
+{
+	return CountedAlloc(sSize);
+}
+
+void operator delete(void * pMemory) throw()
+{
+	free(pMemory);
+}
+
+void operator delete[](void * pMemory) throw()
+{
+	free(pMemory);
+}
+
+#endif
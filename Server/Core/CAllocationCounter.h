@@ -0,0 +1,28 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CAllocationCounter.h
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+// Allocation Counter Enabled (replaces the global operator new, only define it for benchmark builds)
+//#define ALLOCATION_COUNTER_ENABLED
+
+// Counts every heap allocation made through the global operator new of the server (allocations made
+// with malloc directly, e.g. by the squirrel vm, aren't counted). Used by the benchmark commands, the
+// count includes the allocations of other threads.
+class CAllocationCounter
+{
+public:
+#ifdef ALLOCATION_COUNTER_ENABLED
+	static bool         IsEnabled() { return true; }
+	static unsigned int GetCount();
+#else
+	static bool         IsEnabled() { return false; }
+	static unsigned int GetCount() { return 0; }
+#endif
+};
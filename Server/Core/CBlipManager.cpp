@@ -24,8 +24,9 @@ CBlipManager::CBlipManager()
 	for(EntityId x = 0; x < MAX_BLIPS; x++)
 		m_bActive[x] = false;
 
-	for(EntityId y = 0; y < MAX_PLAYERS; y++)
-		m_bPlayerActive[y] = false;
+	// Size the player blips from the max players setting
+	m_bPlayerActive.resize(g_pPlayerManager->GetMaxPlayers(), false);
+	m_PlayerBlips.resize(g_pPlayerManager->GetMaxPlayers());
 }
 
 CBlipManager::~CBlipManager()
@@ -38,7 +39,7 @@ CBlipManager::~CBlipManager()
 		m_bActive[x] = false;
 	}
 
-	for(EntityId y = 0; y < MAX_PLAYERS; y++)
+	for(EntityId y = 0; y < m_bPlayerActive.size(); y++)
 	{
 		if(m_bPlayerActive[y])
 			DeleteForPlayer(y);
@@ -249,8 +250,12 @@ void CBlipManager::HandleClientJoin(EntityId playerId)
 	if(g_pPlayerManager->GetPlayerCount() > 0)
 	{
 		CBitStream bsSend;
-		for(EntityId y = 0; y < MAX_PLAYERS; y++)
+		std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+		for(size_t i = 0; i < pPlayers->size(); i++)
 		{
+			EntityId y = (*pPlayers)[i];
+
 			if(m_bPlayerActive[y])
 			{
 				bsSend.WriteCompressed(y);
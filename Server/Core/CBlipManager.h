@@ -12,6 +12,7 @@
 
 #include "Main.h"
 #include "Interfaces/InterfaceCommon.h"
+#include <vector>
 
 struct _Blip
 {
@@ -39,8 +40,8 @@ private:
 	bool m_bActive[MAX_BLIPS];
 	_Blip m_Blips[MAX_BLIPS];
 
-	bool m_bPlayerActive[MAX_PLAYERS];
-	_PlayerBlip m_PlayerBlips[MAX_PLAYERS];
+	std::vector<bool> m_bPlayerActive;
+	std::vector<_PlayerBlip> m_PlayerBlips;
 
 public:
 	CBlipManager();
@@ -70,7 +71,7 @@ public:
 	void	     TogglePlayerShortRangeForPlayer(EntityId playerId, EntityId toPlayerId, bool bToggle);
 	void		 SetSpriteForPlayer(EntityId playerId, int iSprite);
 	void		 TogglePlayerDisplayForPlayer(EntityId playerId, EntityId toPlayerId, bool bToggle);
-	bool		 DoesPlayerBlipExist(EntityId playerId) { return m_bPlayerActive[playerId]; }
+	bool		 DoesPlayerBlipExist(EntityId playerId) { return (playerId < m_bPlayerActive.size() && m_bPlayerActive[playerId]); }
 
 	int			 GetPlayerBlipSprite(EntityId playerId) { return m_PlayerBlips[playerId].iSprite; }
 	bool		 GetPlayerBlipShow(EntityId playerId) { return m_PlayerBlips[playerId].bShow; }
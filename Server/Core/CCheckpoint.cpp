@@ -10,9 +10,11 @@
 #include "CCheckpoint.h"
 #include "CNetworkManager.h"
 #include "CPlayerManager.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CPlayerManager  * g_pPlayerManager;
+extern CWorldSnapshot  * g_pWorldSnapshot;
 
 CCheckpoint::CCheckpoint(EntityId checkpointId, WORD wType, CVector3 vecPosition, CVector3 vecTargetPosition, float fRadius)
 {
@@ -22,6 +24,7 @@ CCheckpoint::CCheckpoint(EntityId checkpointId, WORD wType, CVector3 vecPosition
 	m_vecTargetPosition = vecTargetPosition;
 	m_fRadius = fRadius;
 	m_bShow = true;
+	m_ucDimension = 0;
 }
 
 CCheckpoint::~CCheckpoint()
@@ -37,7 +40,11 @@ void CCheckpoint::AddForPlayer(EntityId playerId)
 	bsSend.Write(m_vecPosition);
 	bsSend.Write(m_vecTargetPosition);
 	bsSend.Write(m_fRadius);
-	g_pNetworkManager->RPC(RPC_NewCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_NewCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_NewCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 
 	if(m_bShow)
 		ShowForPlayer(playerId);
@@ -47,27 +54,23 @@ void CCheckpoint::AddForPlayer(EntityId playerId)
 
 void CCheckpoint::AddForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			AddForPlayer(i);
-	}
+	AddForPlayer(INVALID_ENTITY_ID);
 }
 
 void CCheckpoint::DeleteForPlayer(EntityId playerId)
 {
 	CBitStream bsSend;
 	bsSend.Write(m_checkpointId);
-	g_pNetworkManager->RPC(RPC_DeleteCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_DeleteCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_DeleteCheckpoint, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CCheckpoint::DeleteForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			DeleteForPlayer(i);
-	}
+	DeleteForPlayer(INVALID_ENTITY_ID);
 }
 
 void CCheckpoint::ShowForPlayer(EntityId playerId)
@@ -76,40 +79,43 @@ void CCheckpoint::ShowForPlayer(EntityId playerId)
 	bsSend.Write(m_checkpointId);
 	bsSend.Write(m_vecPosition);
 	bsSend.Write(m_vecTargetPosition);
-	g_pNetworkManager->RPC(RPC_ScriptingShowCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_ScriptingShowCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_ScriptingShowCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CCheckpoint::ShowForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			ShowForPlayer(i);
-	}
+	ShowForPlayer(INVALID_ENTITY_ID);
 	m_bShow = true;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 }
 
 void CCheckpoint::HideForPlayer(EntityId playerId)
 {
 	CBitStream bsSend;
 	bsSend.Write(m_checkpointId);
-	g_pNetworkManager->RPC(RPC_ScriptingHideCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_ScriptingHideCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_ScriptingHideCheckpointForPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CCheckpoint::HideForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			HideForPlayer(i);
-	}
+	HideForPlayer(INVALID_ENTITY_ID);
 	m_bShow = false;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 }
 
 void CCheckpoint::SetType(WORD wType)
 {
 	// Set the type
 	m_wType = wType;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 
 	// Respawn the checkpoint
 	HideForWorld();
@@ -120,6 +126,7 @@ void CCheckpoint::SetPosition(CVector3 vecPosition)
 {
 	// Set the position
 	m_vecPosition = vecPosition;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 
 	// Respawn the checkpoint
 	HideForWorld();
@@ -130,6 +137,7 @@ void CCheckpoint::SetTargetPosition(CVector3 vecTargetPosition)
 {
 	// Set the target position
 	m_vecTargetPosition = vecTargetPosition;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 
 	// Respawn the checkpoint
 	HideForWorld();
@@ -140,6 +148,7 @@ void CCheckpoint::SetRadius(float fRadius)
 {
 	// Set the radius
 	m_fRadius = fRadius;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 
 	// Respawn the checkpoint
 	HideForWorld();
@@ -150,10 +159,18 @@ void CCheckpoint::SetRadius(float fRadius)
 void CCheckpoint::SetDimension(unsigned char ucDimension)
 {
 	m_ucDimension = ucDimension;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
+	SetDimensionForPlayer(INVALID_ENTITY_ID);
+}
 
+void CCheckpoint::SetDimensionForPlayer(EntityId playerId)
+{
 	CBitStream bsSend;
 	bsSend.WriteCompressed(GetCheckpointId());
-	bsSend.Write(ucDimension);
+	bsSend.Write(m_ucDimension);
 
-	g_pNetworkManager->RPC(RPC_ScriptingSetCheckpointDimension, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPC(RPC_ScriptingSetCheckpointDimension, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
+	else
+		g_pNetworkManager->RPC(RPC_ScriptingSetCheckpointDimension, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
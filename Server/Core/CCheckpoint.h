@@ -45,5 +45,6 @@ public:
 	void     SetRadius(float fRadius);
 	float    GetRadius() { return m_fRadius; }
 	void	 SetDimension(unsigned char ucDimension);
+	void     SetDimensionForPlayer(EntityId playerId);
 	unsigned char GetDimension() { return m_ucDimension; }
 };
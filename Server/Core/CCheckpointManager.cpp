@@ -11,9 +11,11 @@
 #include "CCheckpointManager.h"
 #include "CNetworkManager.h"
 #include "CEvents.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CEvents         * g_pEvents;
+extern CWorldSnapshot  * g_pWorldSnapshot;
 
 CCheckpointManager::CCheckpointManager()
 {
@@ -43,6 +45,7 @@ EntityId CCheckpointManager::Add(WORD wType, CVector3 vecPosition, CVector3 vecT
 
 			// Set the checkpoint
 			m_pCheckpoints[i] = pCheckpoint;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 
 			// Add it for all players
 			pCheckpoint->AddForWorld();
@@ -74,6 +77,7 @@ bool CCheckpointManager::Delete(EntityId checkpointId)
 
 	// Delete the checkpoint
 	SAFE_DELETE(m_pCheckpoints[checkpointId]);
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_CHECKPOINTS);
 	return true;
 }
 
@@ -87,7 +91,7 @@ void CCheckpointManager::HandleClientJoin(EntityId playerId)
 		{
 			// Add it for the player
 			m_pCheckpoints[i]->AddForPlayer(playerId);
-			m_pCheckpoints[i]->SetDimension(m_pCheckpoints[i]->GetDimension());
+			m_pCheckpoints[i]->SetDimensionForPlayer(playerId);
 		}
 	}
 }
@@ -16,11 +16,14 @@
 #include <ctime>
 #include "CPlayerManager.h"
 #include "CNetworkManager.h"
+#include "CTickScheduler.h"
 #include <Network/CNetworkModule.h>
 #include <CLogFile.h>
+#include <CSettings.h>
 
 extern CPlayerManager  * g_pPlayerManager;
 extern CNetworkManager * g_pNetworkManager;
+extern CTickScheduler  * g_pTickScheduler;
 
 CNetworkManager::CNetworkManager()
 {
@@ -36,6 +39,27 @@ CNetworkManager::CNetworkManager()
 	// Create the rpc handler instance
 	m_pServerRPCHandler = new CServerRPCHandler();
 
+	// Reset the sync batches (they are created on startup)
+	m_maxPlayers = 0;
+	m_pSyncBatches = NULL;
+
+	// Reset the sync radius (it is read every process)
+	m_fSyncRadius = 0.0f;
+	m_fSyncQueryRadius = 0.0f;
+
+	// Reset the rpc capture
+	m_capturePlayerId = INVALID_ENTITY_ID;
+	m_pCaptureBitStream = NULL;
+	m_uiCaptureCount = 0;
+
+	// Reset the rpc send stats
+	ResetRPCSendStats();
+
+	// Reset the packet replay
+	m_bReplayingPackets = false;
+	m_ulReplayStartTime = 0;
+	m_uiReplayStartPackets = 0;
+
 	// Flag ourselves as running
 	bRunning = true;
 }
@@ -62,6 +86,9 @@ CNetworkManager::~CNetworkManager()
 
 	// Delete the net server instance
 	CNetworkModule::DestroyNetServerInterface(m_pNetServer);
+
+	// Delete the sync batches
+	SAFE_DELETE_ARRAY(m_pSyncBatches);
 }
 
 bool CNetworkManager::Startup(int iPort, int iMaxPlayers, String strPassword, String strHostAddress)
@@ -78,6 +105,19 @@ bool CNetworkManager::Startup(int iPort, int iMaxPlayers, String strPassword, St
 
 	// Register the rpcs
 	m_pServerRPCHandler->Register();
+
+	// Load the sync distance tiers
+	m_fSyncNearDistance = CVAR_GET_FLOAT("syncneardistance");
+	m_fSyncMidDistance = CVAR_GET_FLOAT("syncmiddistance");
+	m_ucSyncMidInterval = (unsigned char)CVAR_GET_INTEGER("syncmidinterval");
+	m_ucSyncFarInterval = (unsigned char)CVAR_GET_INTEGER("syncfarinterval");
+
+	// Create the sync schedule (one counter for each sender and recipient) and batches
+	m_maxPlayers = (EntityId)iMaxPlayers;
+	m_ucSyncCounters.assign((m_maxPlayers * m_maxPlayers), 0);
+	m_pSyncBatches = new CBitStream[m_maxPlayers];
+	m_ucSyncBatchCount.assign(m_maxPlayers, 0);
+	m_pendingSyncBatches.reserve(m_maxPlayers);
 	return true;
 }
 
@@ -96,20 +136,322 @@ void CNetworkManager::PacketHandler(CPacket * pPacket)
 	}
 }
 
+void CNetworkManager::UpdateSyncRadius()
+{
+	// Read the sync radius setting once for all sync handled this process
+	m_fSyncRadius = CVAR_GET_FLOAT("syncradius");
+
+	// Get the biggest sync radius of all players, that is how far a sender has to look for recipients
+	m_fSyncQueryRadius = 0.0f;
+	std::vector<EntityId> * pActivePlayers = g_pPlayerManager->GetActivePlayers();
+
+	for(std::vector<EntityId>::iterator iter = pActivePlayers->begin(); iter != pActivePlayers->end(); iter++)
+	{
+		float fRadius = g_pPlayerManager->GetAt(*iter)->GetSyncRadius();
+
+		// Does this player want sync from everywhere?
+		if(fRadius <= 0.0f)
+		{
+			m_fSyncQueryRadius = 0.0f;
+			return;
+		}
+
+		if(fRadius > m_fSyncQueryRadius)
+			m_fSyncQueryRadius = fRadius;
+	}
+}
+
 void CNetworkManager::Process()
 {
+	// Update the sync radius before the net server handles this processes sync
+	UpdateSyncRadius();
+
 	// Process the net server
 	m_pNetServer->Process();
 
+	// Has the packet replay finished?
+	if(m_bReplayingPackets && !m_pNetServer->IsReplayingPackets())
+		StopPacketReplay();
+
 	// Process the player manager
 	g_pPlayerManager->Pulse();
 }
 
+bool CNetworkManager::StartPacketReplay(String strFileName, bool bFast)
+{
+	// Replay the packets at real speed or move the replay on by one tick interval every process
+	unsigned int uiTimeStep = 0;
+
+	if(bFast)
+	{
+		uiTimeStep = (g_pTickScheduler->GetTickInterval() / 1000);
+
+		if(uiTimeStep == 0)
+			uiTimeStep = 1;
+	}
+
+	if(!m_pNetServer->StartPacketReplay(strFileName, uiTimeStep))
+		return false;
+
+	NetPacketStats stats;
+	m_pNetServer->GetPacketStats(&stats);
+	m_bReplayingPackets = true;
+	m_ulReplayStartTime = SharedUtility::GetTime();
+	m_uiReplayStartPackets = stats.uiPacketsReplayed;
+	CLogFile::Printf("Packet replay of %s started.", strFileName.Get());
+	return true;
+}
+
+void CNetworkManager::StopPacketReplay()
+{
+	if(!m_bReplayingPackets)
+		return;
+
+	m_pNetServer->StopPacketReplay();
+	NetPacketStats stats;
+	m_pNetServer->GetPacketStats(&stats);
+	m_bReplayingPackets = false;
+	CLogFile::Printf("Packet replay finished (%d packet(s) in %d ms).", (stats.uiPacketsReplayed - m_uiReplayStartPackets), (SharedUtility::GetTime() - m_ulReplayStartTime));
+}
+
+bool CNetworkManager::WaitForPackets(unsigned int uiTimeout)
+{
+	return m_pNetServer->WaitForPackets(uiTimeout);
+}
+
 void CNetworkManager::RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel)
 {
+	// Are we capturing the rpcs sent to this player?
+	if(m_pCaptureBitStream && !bBroadcast && playerId == m_capturePlayerId)
+	{
+		// Write the rpc id, size and data to the capture bit stream
+		unsigned int uiSizeInBits = (pBitStream ? pBitStream->GetNumberOfBitsUsed() : 0);
+		m_pCaptureBitStream->Write(rpcId);
+		m_pCaptureBitStream->WriteCompressed(uiSizeInBits);
+
+		if(pBitStream)
+			m_pCaptureBitStream->Write((const CBitStream *)pBitStream);
+
+		m_uiCaptureCount++;
+		return;
+	}
+
+	// Choose the packet channel from the rpc id
+	if(cOrderingChannel == PACKET_CHANNEL_DEFAULT)
+		cOrderingChannel = GetRPCChannel(rpcId);
+
+	// Count the rpc once for each player it is sent to
+	unsigned int uiMessages = 1;
+
+	if(bBroadcast)
+	{
+		uiMessages = g_pPlayerManager->GetPlayerCount();
+
+		if(uiMessages > 0 && g_pPlayerManager->DoesExist(playerId))
+			uiMessages--;
+	}
+
+	AddSendStats(rpcId, uiMessages, (pBitStream ? pBitStream->GetNumberOfBytesUsed() : 0));
 	m_pNetServer->RPC(rpcId, pBitStream, priority, reliability, playerId, bBroadcast, cOrderingChannel);
 }
 
+void CNetworkManager::StartCapture(EntityId playerId, CBitStream * pBitStream)
+{
+	// Start capturing the rpcs sent to this player instead of sending them
+	m_capturePlayerId = playerId;
+	m_pCaptureBitStream = pBitStream;
+	m_uiCaptureCount = 0;
+}
+
+unsigned int CNetworkManager::StopCapture()
+{
+	// Stop capturing and return the amount of rpcs we captured
+	m_capturePlayerId = INVALID_ENTITY_ID;
+	m_pCaptureBitStream = NULL;
+	return m_uiCaptureCount;
+}
+
+void CNetworkManager::RPCToMany(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel)
+{
+	// Are we capturing rpcs or is there only one player? (send them one by one)
+	if(m_pCaptureBitStream || uiPlayerCount == 1)
+	{
+		for(unsigned int i = 0; i < uiPlayerCount; i++)
+			RPC(rpcId, pBitStream, priority, reliability, pPlayerIds[i], false, cOrderingChannel);
+
+		return;
+	}
+
+	// Choose the packet channel from the rpc id
+	if(cOrderingChannel == PACKET_CHANNEL_DEFAULT)
+		cOrderingChannel = GetRPCChannel(rpcId);
+
+	// Frame the rpc once and send it to all players
+	if(uiPlayerCount > 0)
+	{
+		AddSendStats(rpcId, uiPlayerCount, (pBitStream ? pBitStream->GetNumberOfBytesUsed() : 0));
+		m_pNetServer->RPCToMany(rpcId, pBitStream, priority, reliability, pPlayerIds, uiPlayerCount, cOrderingChannel);
+	}
+}
+
+void CNetworkManager::RPCToPlayers(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId excludedPlayerId, char cOrderingChannel)
+{
+	// Get the players that have joined
+	std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+	m_recipients.clear();
+
+	for(size_t i = 0; i < pPlayers->size(); i++)
+	{
+		if((*pPlayers)[i] != excludedPlayerId)
+			m_recipients.push_back((*pPlayers)[i]);
+	}
+
+	// Send the rpc to each of them
+	if(!m_recipients.empty())
+		RPCToMany(rpcId, pBitStream, priority, reliability, &m_recipients[0], (unsigned int)m_recipients.size(), cOrderingChannel);
+}
+
+void CNetworkManager::RPCToDimension(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, unsigned char ucDimension, EntityId excludedPlayerId, char cOrderingChannel)
+{
+	// Get the players in this dimension
+	std::set<EntityId> * pPlayers = g_pPlayerManager->GetDimensionPlayers(ucDimension);
+	m_recipients.clear();
+
+	for(std::set<EntityId>::iterator iter = pPlayers->begin(); iter != pPlayers->end(); iter++)
+	{
+		if(*iter != excludedPlayerId)
+			m_recipients.push_back(*iter);
+	}
+
+	// Send the rpc to each of them
+	if(!m_recipients.empty())
+		RPCToMany(rpcId, pBitStream, priority, reliability, &m_recipients[0], (unsigned int)m_recipients.size(), cOrderingChannel);
+}
+
+void CNetworkManager::ResetSyncSchedule(EntityId playerId)
+{
+	if(playerId >= m_maxPlayers)
+		return;
+
+	// Reset the schedule of everything this player sends and receives
+	for(EntityId i = 0; i < m_maxPlayers; i++)
+	{
+		m_ucSyncCounters[(playerId * m_maxPlayers) + i] = 0;
+		m_ucSyncCounters[(i * m_maxPlayers) + playerId] = 0;
+	}
+
+	// Drop anything still queued for this player
+	m_pSyncBatches[playerId].Reset();
+	m_ucSyncBatchCount[playerId] = 0;
+}
+
+bool CNetworkManager::ShouldSendSync(EntityId senderId, EntityId recipientId, float fDistance)
+{
+	if(senderId >= m_maxPlayers || recipientId >= m_maxPlayers)
+		return false;
+
+	unsigned char& ucCounter = m_ucSyncCounters[(senderId * m_maxPlayers) + recipientId];
+
+	// Near players get every update
+	if(fDistance <= m_fSyncNearDistance)
+	{
+		ucCounter = 0;
+		return true;
+	}
+
+	// Mid range players get every Nth update, far players only a heartbeat
+	unsigned char ucInterval = ((fDistance <= m_fSyncMidDistance) ? m_ucSyncMidInterval : m_ucSyncFarInterval);
+
+	// Is this recipient due an update from the sender?
+	if(++ucCounter < ucInterval)
+		return false;
+
+	ucCounter = 0;
+	return true;
+}
+
+void CNetworkManager::QueueSync(RPCIdentifier rpcId, CBitStream * pBitStream, EntityId playerId)
+{
+	if(playerId >= m_maxPlayers)
+		return;
+
+	// Is the sync too big to be batched?
+	if(pBitStream->GetNumberOfBitsUsed() >= (1 << SYNC_BATCH_ENTRY_SIZE_BITS))
+	{
+		RPC(rpcId, pBitStream, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, playerId, false);
+		return;
+	}
+
+	CBitStream * pBatch = &m_pSyncBatches[playerId];
+
+	// Would the sync make the batch too big? (rpc id, size and data)
+	if(m_ucSyncBatchCount[playerId] == 0xFF || 
+		(pBatch->GetNumberOfBytesUsed() + pBitStream->GetNumberOfBytesUsed() + 3) > SYNC_BATCH_MAX_SIZE)
+	{
+		FlushSyncBatch(playerId);
+	}
+
+	// Is this the first sync in the batch?
+	if(m_ucSyncBatchCount[playerId] == 0)
+		m_pendingSyncBatches.push_back(playerId);
+
+	// Count the sync under its own rpc (with its batch entry header)
+	AddSendStats(rpcId, 1, (pBitStream->GetNumberOfBytesUsed() + 2));
+
+	// Add the sync to the batch
+	pBatch->Write(rpcId);
+	pBatch->WriteUInt(pBitStream->GetNumberOfBitsUsed(), SYNC_BATCH_ENTRY_SIZE_BITS);
+	pBatch->Write(pBitStream);
+	m_ucSyncBatchCount[playerId]++;
+}
+
+void CNetworkManager::FlushSyncBatch(EntityId playerId)
+{
+	// Do we have anything queued for this player?
+	if(m_ucSyncBatchCount[playerId] == 0)
+		return;
+
+	// Send all of the queued sync as one rpc
+	CBitStream bsSend;
+	bsSend.Write(m_ucSyncBatchCount[playerId]);
+	bsSend.Write(&m_pSyncBatches[playerId]);
+
+	// The syncs in the batch have already been counted, only count the batch header
+	m_rpcSendStats[RPC_BatchedSync].uiMessages++;
+	m_rpcSendStats[RPC_BatchedSync].ullBytes += (bsSend.GetNumberOfBytesUsed() - m_pSyncBatches[playerId].GetNumberOfBytesUsed());
+	m_pNetServer->RPC(RPC_BatchedSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, playerId, false, GetRPCChannel(RPC_BatchedSync));
+
+	// Reset the batch
+	m_pSyncBatches[playerId].Reset();
+	m_ucSyncBatchCount[playerId] = 0;
+}
+
+void CNetworkManager::AddSendStats(RPCIdentifier rpcId, unsigned int uiMessages, unsigned int uiBytes)
+{
+	// Add the rpc id to the size of each message
+	m_rpcSendStats[rpcId].uiMessages += uiMessages;
+	m_rpcSendStats[rpcId].ullBytes += ((unsigned long long)(uiBytes + sizeof(RPCIdentifier)) * uiMessages);
+}
+
+void CNetworkManager::ResetRPCSendStats()
+{
+	memset(m_rpcSendStats, 0, sizeof(m_rpcSendStats));
+}
+
+bool CNetworkManager::GetPlayerNetStats(EntityId playerId, CNetStats * pNetStats)
+{
+	return m_pNetServer->GetPlayerNetStats(playerId, pNetStats);
+}
+
+void CNetworkManager::FlushSyncBatches()
+{
+	// Only flush the batches that had something queued this tick
+	for(size_t i = 0; i < m_pendingSyncBatches.size(); i++)
+		FlushSyncBatch(m_pendingSyncBatches[i]);
+
+	m_pendingSyncBatches.clear();
+}
+
 String CNetworkManager::GetPlayerIp(EntityId playerId)
 {
 	return m_pNetServer->GetPlayerIp(playerId);
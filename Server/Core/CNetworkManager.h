@@ -18,6 +18,17 @@
 #include <Network/CNetServerInterface.h>
 #include "CServerPacketHandler.h"
 #include "CServerRPCHandler.h"
+#include <vector>
+
+// Max size of a batched sync (in bytes), kept below the MTU so batches don't get split
+#define SYNC_BATCH_MAX_SIZE 1024
+
+// Amount of messages and bytes we have sent of one rpc
+struct RPCSendStats
+{
+	unsigned int       uiMessages;
+	unsigned long long ullBytes;
+};
 
 class CNetworkManager : public CNetworkManagerInterface
 {
@@ -25,16 +36,58 @@ private:
 	CNetServerInterface  * m_pNetServer;
 	CServerPacketHandler * m_pServerPacketHandler;
 	CServerRPCHandler    * m_pServerRPCHandler;
+	float                  m_fSyncNearDistance;
+	float                  m_fSyncMidDistance;
+	unsigned char          m_ucSyncMidInterval;
+	unsigned char          m_ucSyncFarInterval;
+	float                  m_fSyncRadius;
+	float                  m_fSyncQueryRadius;
+	EntityId               m_maxPlayers;
+	std::vector<unsigned char> m_ucSyncCounters;
+	CBitStream           * m_pSyncBatches;
+	std::vector<unsigned char> m_ucSyncBatchCount;
+	std::vector<EntityId>  m_pendingSyncBatches;
+	std::vector<EntityId>  m_recipients;
+	EntityId               m_capturePlayerId;
+	CBitStream           * m_pCaptureBitStream;
+	unsigned int           m_uiCaptureCount;
+	RPCSendStats           m_rpcSendStats[MAX_RPC_IDENTIFIERS];
+	bool                   m_bReplayingPackets;
+	unsigned long          m_ulReplayStartTime;
+	unsigned int           m_uiReplayStartPackets;
+
+	void                   UpdateSyncRadius();
+	void                   FlushSyncBatch(EntityId playerId);
+	void                   AddSendStats(RPCIdentifier rpcId, unsigned int uiMessages, unsigned int uiBytes);
 
 public:
 	CNetworkManager();
 	~CNetworkManager();
 
 	CNetServerInterface * GetNetServer() { return m_pNetServer; }
+	CServerPacketHandler * GetPacketHandler() { return m_pServerPacketHandler; }
+	CServerRPCHandler   * GetRPCHandler() { return m_pServerRPCHandler; }
 	bool                  Startup(int iPort, int iMaxPlayers, String strPassword, String strHostAddress);
 	static void           PacketHandler(CPacket * pPacket);
 	void                  Process();
+	bool                  WaitForPackets(unsigned int uiTimeout);
 	void                  RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	void                  RPCToMany(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	void                  RPCToPlayers(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId excludedPlayerId = INVALID_ENTITY_ID, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	void                  RPCToDimension(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, unsigned char ucDimension, EntityId excludedPlayerId = INVALID_ENTITY_ID, char cOrderingChannel = PACKET_CHANNEL_DEFAULT);
+	float                 GetSyncRadius() { return m_fSyncRadius; }
+	float                 GetSyncQueryRadius() { return m_fSyncQueryRadius; }
+	void                  ResetSyncSchedule(EntityId playerId);
+	bool                  ShouldSendSync(EntityId senderId, EntityId recipientId, float fDistance);
+	void                  QueueSync(RPCIdentifier rpcId, CBitStream * pBitStream, EntityId playerId);
+	void                  FlushSyncBatches();
+	void                  StartCapture(EntityId playerId, CBitStream * pBitStream);
+	unsigned int          StopCapture();
+	bool                  StartPacketReplay(String strFileName, bool bFast);
+	void                  StopPacketReplay();
+	RPCSendStats        * GetRPCSendStats(RPCIdentifier rpcId) { return &m_rpcSendStats[rpcId]; }
+	void                  ResetRPCSendStats();
+	bool                  GetPlayerNetStats(EntityId playerId, CNetStats * pNetStats);
 	String                GetPlayerIp(EntityId playerId);
 	unsigned short        GetPlayerPort(EntityId playerId);
 	String                GetPlayerSerial(EntityId playerId);
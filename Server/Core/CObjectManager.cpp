@@ -11,10 +11,12 @@
 #include "CNetworkManager.h"
 #include "CEvents.h"
 #include "CModuleManager.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CEvents         * g_pEvents;
 extern CModuleManager  * g_pModuleManager;
+extern CWorldSnapshot  * g_pWorldSnapshot;
 
 CObjectManager::CObjectManager()
 {
@@ -64,6 +66,8 @@ EntityId CObjectManager::Create(DWORD dwModelHash, const CVector3& vecPosition,
 			m_Objects[x].vecRotation = vecRotation;
 			m_bActive[x] = true;
 			m_Objects[x].iBone = -1;
+			m_Objects[x].ucDimension = 0;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 			
 			CSquirrelArguments pArguments;
 			pArguments.push(x);
@@ -88,6 +92,7 @@ void CObjectManager::Delete(EntityId objectId)
 	bsSend.WriteCompressed(objectId);
 	g_pNetworkManager->RPC(RPC_DeleteObject, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
 	m_bActive[objectId] = false;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 }
 
 void CObjectManager::HandleClientJoin(EntityId playerId)
@@ -117,12 +122,22 @@ void CObjectManager::HandleClientJoin(EntityId playerId)
 					bsSend.Write1();
 					bsSend.Write(m_Objects[x].iBone);
 				}
-
-				this->SetDimension(x, this->GetDimension(x));			
 			}
 		}
 
 		g_pNetworkManager->RPC(RPC_NewObject, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+		// Send the object dimensions to the player once the objects are created
+		for(EntityId x = 0; x < MAX_OBJECTS; x++)
+		{
+			if(m_bActive[x])
+			{
+				bsSend.Reset();
+				bsSend.WriteCompressed(x);
+				bsSend.Write(m_Objects[x].ucDimension);
+				g_pNetworkManager->RPC(RPC_ScriptingSetObjectDimension, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+			}
+		}
 	}
 }
 
@@ -160,6 +175,7 @@ bool CObjectManager::SetPosition(EntityId objectId, const CVector3& vecPosition)
 	if(DoesExist(objectId))
 	{
 		m_Objects[objectId].vecPosition = vecPosition;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
@@ -188,6 +204,7 @@ bool CObjectManager::SetRotation(EntityId objectId, const CVector3& vecRotation)
 	if(DoesExist(objectId))
 	{
 		m_Objects[objectId].vecRotation = vecRotation;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
@@ -225,6 +242,7 @@ EntityId CObjectManager::CreateFire(const CVector3& vecPos, float fdensity)
 			m_FireObject[x].vecPosition = vecPos;
 			m_FireObject[x].fdensity = fdensity;
 			m_bFireActive[x] = true;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_FIRES);
 			return x;
 		}
 	}
@@ -240,6 +258,7 @@ void CObjectManager::DeleteFire(EntityId fireId)
 		g_pNetworkManager->RPC(RPC_ScriptingDeleteFire, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
 		m_FireObject[fireId].vecPosition = CVector3(0.0f,0.0f,0.0f);
 		m_bFireActive[fireId] = false;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_FIRES);
 	}
 }
 
@@ -276,6 +295,7 @@ void CObjectManager::AttachToPlayer(EntityId objectId, EntityId playerId, const
 		m_Objects[objectId].vecAttachPosition = vecPos;
 		m_Objects[objectId].vecAttachRotation = vecRot;
 		m_Objects[objectId].iBone = iBone;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
@@ -304,6 +324,7 @@ void CObjectManager::AttachToVehicle(EntityId objectId, EntityId vehicleId,const
 		m_Objects[objectId].uiVehiclePlayerId = vehicleId;
 		m_Objects[objectId].vecAttachPosition = vecPos;
 		m_Objects[objectId].vecAttachRotation = vecRot;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
@@ -327,6 +348,7 @@ void CObjectManager::Detach(EntityId objectId)
 		m_Objects[objectId].vecAttachPosition = CVector3();
 		m_Objects[objectId].vecAttachRotation = CVector3();
 		m_Objects[objectId].iBone = -1;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
@@ -343,6 +365,7 @@ void CObjectManager::MoveObject(EntityId objectId, const CVector3& vecMoveTarget
 		bsSend.Write(vecMoveTarget);
 		bsSend.Write(fSpeed);
 		m_Objects[objectId].vecPosition = vecMoveTarget;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		if((vecMoveRot - m_Objects[objectId].vecPosition).Length() != 0) {
 			bsSend.Write1();
@@ -364,6 +387,7 @@ void CObjectManager::RotateObject(EntityId objectId, const CVector3& vecMoveRot,
 		bsSend.Write(vecMoveRot);
 		bsSend.Write(fSpeed);
 		m_Objects[objectId].vecRotation = vecMoveRot;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		g_pNetworkManager->RPC(RPC_ScriptingRotateObject, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
 	}
@@ -374,6 +398,7 @@ void CObjectManager::SetDimension(EntityId objectId, unsigned char ucDimension)
 {
 	if(DoesExist(objectId)) {
 		m_Objects[objectId].ucDimension = ucDimension;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_OBJECTS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(objectId);
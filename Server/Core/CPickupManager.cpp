@@ -10,9 +10,11 @@
 #include "CPickupManager.h"
 #include "CNetworkManager.h"
 #include "CEvents.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CEvents * g_pEvents;
+extern CWorldSnapshot * g_pWorldSnapshot;
 
 CPickupManager::CPickupManager()
 {
@@ -45,6 +47,7 @@ EntityId CPickupManager::Create(DWORD dwModelHash, unsigned char ucType, unsigne
 			m_Pickups[x].ucType = ucType;
 			m_Pickups[x].uiValue = uiValue;
 			m_bActive[x] = true;
+			g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_PICKUPS);
 
 			CBitStream bsSend;
 			bsSend.WriteCompressed(x);
@@ -78,6 +81,7 @@ void CPickupManager::Delete(EntityId pickupId)
 	bsSend.WriteCompressed(pickupId);
 	g_pNetworkManager->RPC(RPC_DeletePickup, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
 	m_bActive[pickupId] = false;
+	g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_PICKUPS);
 }
 
 void CPickupManager::HandleClientJoin(EntityId playerId)
@@ -148,6 +152,7 @@ bool CPickupManager::SetValue(EntityId pickupId, unsigned int pValue)
 	if(DoesExist(pickupId))
 	{
 		m_Pickups[pickupId].uiValue = pValue;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_PICKUPS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(pickupId);
@@ -173,6 +178,7 @@ bool CPickupManager::SetPosition(EntityId pickupId, CVector3 vecPosition)
 	if(DoesExist(pickupId))
 	{
 		m_Pickups[pickupId].vecPos = vecPosition;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_PICKUPS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(pickupId);
@@ -199,6 +205,7 @@ bool CPickupManager::SetRotation(EntityId pickupId, CVector3 vecRotation)
 	if(DoesExist(pickupId))
 	{
 		m_Pickups[pickupId].vecRot = vecRotation;
+		g_pWorldSnapshot->MarkDirty(WORLD_SNAPSHOT_PICKUPS);
 
 		CBitStream bsSend;
 		bsSend.WriteCompressed(pickupId);
@@ -58,7 +58,8 @@ CPlayer::CPlayer(EntityId playerId, String strName)
 	m_uWeapon = 0;
 	m_uAmmo = 0;
 	memset(&m_aimSyncData, 0, sizeof(AimSyncData));
-	m_uiColor = playerColors[playerId];
+	m_fSyncRadius = -1.0f;
+	m_uiColor = playerColors[playerId % (sizeof(playerColors) / sizeof(playerColors[0]))];
 	memset(&m_ucClothes, 0, sizeof(m_ucClothes));
 	m_bHelmet = false;
 	m_szAnimSpec = NULL;
@@ -105,7 +106,8 @@ void CPlayer::SetState(eStateType state)
 		pArguments.push(m_playerId);
 		pArguments.push(m_state);
 		pArguments.push(state);
-		g_pEvents->Call("playerChangeState", &pArguments);
+		static EventId changeStateEvent = g_pEvents->GetEventId("playerChangeState");
+		g_pEvents->Call(changeStateEvent, &pArguments);
 
 		m_state = state;
 	}
@@ -122,32 +124,32 @@ void CPlayer::AddForPlayer(EntityId playerId)
 	bsSend.WriteCompressed(m_playerId);
 	bsSend.Write(m_uiColor);
 	bsSend.Write(m_strName);
-	g_pNetworkManager->RPC(RPC_NewPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_NewPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_playerId);
+	else
+		g_pNetworkManager->RPC(RPC_NewPlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CPlayer::DeleteForPlayer(EntityId playerId)
 {
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
-	g_pNetworkManager->RPC(RPC_DeletePlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_DeletePlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_playerId);
+	else
+		g_pNetworkManager->RPC(RPC_DeletePlayer, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CPlayer::AddForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i) && i != m_playerId)
-			AddForPlayer(i);
-	}
+	AddForPlayer(INVALID_ENTITY_ID);
 }
 
 void CPlayer::DeleteForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i) && i != m_playerId)
-			DeleteForPlayer(i);
-	}
+	DeleteForPlayer(INVALID_ENTITY_ID);
 }
 
 void CPlayer::SpawnForPlayer(EntityId playerId)
@@ -186,35 +188,35 @@ void CPlayer::SpawnForPlayer(EntityId playerId)
 			bsSend.Write(m_ucClothes[uc]);
 	}
 
-	g_pNetworkManager->RPC(RPC_PlayerSpawn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_PlayerSpawn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_playerId);
+	else
+		g_pNetworkManager->RPC(RPC_PlayerSpawn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CPlayer::KillForPlayer(EntityId playerId)
 {
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
-	g_pNetworkManager->RPC(RPC_PlayerDeath, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_PlayerDeath, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_playerId);
+	else
+		g_pNetworkManager->RPC(RPC_PlayerDeath, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CPlayer::SpawnForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i) && i != m_playerId)
-			SpawnForPlayer(i);
-	}
+	SpawnForPlayer(INVALID_ENTITY_ID);
 
+	UpdateGridPosition();
 	m_bSpawned = true;
 	SetState(STATE_TYPE_SPAWN);
 }
 
 void CPlayer::KillForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i) && i != m_playerId)
-			KillForPlayer(i);
-	}
+	KillForPlayer(INVALID_ENTITY_ID);
 
 	m_bSpawned = false;
 	SetState(STATE_TYPE_DEATH);
@@ -237,6 +239,7 @@ void CPlayer::StoreOnFootSync(OnFootSyncData * syncPacket, bool bHasAimSyncData,
 
 	// Set the position
 	m_vecPosition = syncPacket->vecPos;
+	UpdateGridPosition();
 
 	// Set the heading
 	m_fHeading = syncPacket->fHeading;
@@ -273,19 +276,19 @@ void CPlayer::StoreOnFootSync(OnFootSyncData * syncPacket, bool bHasAimSyncData,
 	// Set the state to on foot
 	SetState(STATE_TYPE_ONFOOT);
 
-	// Send the sync to all other players
+	// Send the sync to all other players near us
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
 	bsSend.WriteCompressed(GetPing());
 	bsSend.WriteCompressed(m_bHelmet);
-	bsSend.Write((char *)syncPacket, sizeof(OnFootSyncData));
+	bsSend.Write(*syncPacket);
 
 	// Do we have aim sync data?
 	if(bHasAimSyncData)
 	{
 		// Write a 1 bit to say we have aim sync
 		bsSend.Write1();
-		bsSend.Write((char *)aimSyncData, sizeof(AimSyncData));
+		bsSend.Write(*aimSyncData);
 	}
 	else
 	{
@@ -293,7 +296,7 @@ void CPlayer::StoreOnFootSync(OnFootSyncData * syncPacket, bool bHasAimSyncData,
 		bsSend.Write0();
 	}
 
-	g_pNetworkManager->RPC(RPC_OnFootSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, m_playerId, true);
+	BroadcastSync(RPC_OnFootSync, &bsSend);
 }
 
 void CPlayer::StoreInVehicleSync(CVehicle * pVehicle, InVehicleSyncData * syncPacket, bool bHasAimSyncData, AimSyncData * aimSyncData)
@@ -314,6 +317,7 @@ void CPlayer::StoreInVehicleSync(CVehicle * pVehicle, InVehicleSyncData * syncPa
 
 	// Set the position to the vehicle position
 	m_vecPosition = syncPacket->vecPos;
+	UpdateGridPosition();
 
 	// Set the rotation to the vehicle rotation
 	// TODO: Player has full rotation vector too
@@ -341,27 +345,27 @@ void CPlayer::StoreInVehicleSync(CVehicle * pVehicle, InVehicleSyncData * syncPa
 	// Set the state to in vehicle
 	SetState(STATE_TYPE_INVEHICLE);
 
-	// Send the sync to all other players
+	// Send the sync to all other players near us
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
 	bsSend.WriteCompressed(pVehicle->GetVehicleId());
 	bsSend.WriteCompressed(GetPing());
 	bsSend.WriteCompressed(m_bHelmet);
-	bsSend.Write((char *)syncPacket, sizeof(InVehicleSyncData));
+	bsSend.Write(*syncPacket);
 
 	// Do we have aim sync data?
 	if(bHasAimSyncData)
 	{
 		// Write a 1 bit to say we have aim sync
 		bsSend.Write1();
-		bsSend.Write((char *)aimSyncData, sizeof(AimSyncData));
+		bsSend.Write(*aimSyncData);
 	}
 	else
 	{
 		// Write a 0 bit to say we don't have aim sync
 		bsSend.Write0();
 	}
-	g_pNetworkManager->RPC(RPC_InVehicleSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, m_playerId, true);
+	BroadcastSync(RPC_InVehicleSync, &bsSend);
 }
 
 void CPlayer::StorePassengerSync(CVehicle * pVehicle, PassengerSyncData * syncPacket, bool bHasAimSyncData, AimSyncData * aimSyncData)
@@ -389,6 +393,7 @@ void CPlayer::StorePassengerSync(CVehicle * pVehicle, PassengerSyncData * syncPa
 
 	// Set the position to the vehicle position
 	pVehicle->GetPosition(m_vecPosition);
+	UpdateGridPosition();
 
 	// Set the rotation to the vehicle rotation
 	// TODO: Player has full rotation vector too
@@ -410,7 +415,7 @@ void CPlayer::StorePassengerSync(CVehicle * pVehicle, PassengerSyncData * syncPa
 	// Set the state to passenger
 	SetState(STATE_TYPE_PASSENGER);
 
-	// Send the sync to all other players
+	// Send the sync to all other players near us
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
 	bsSend.WriteCompressed(pVehicle->GetVehicleId());
@@ -423,7 +428,7 @@ void CPlayer::StorePassengerSync(CVehicle * pVehicle, PassengerSyncData * syncPa
 	{
 		// Write a 1 bit to say we have aim sync
 		bsSend.Write1();
-		bsSend.Write((char *)aimSyncData, sizeof(AimSyncData));
+		bsSend.Write(*aimSyncData);
 	}
 	else
 	{
@@ -431,7 +436,7 @@ void CPlayer::StorePassengerSync(CVehicle * pVehicle, PassengerSyncData * syncPa
 		bsSend.Write0();
 	}
 
-	g_pNetworkManager->RPC(RPC_PassengerSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, m_playerId, true);
+	BroadcastSync(RPC_PassengerSync, &bsSend);
 }
 
 void CPlayer::StoreSmallSync(SmallSyncData * syncPacket, bool bHasAimSyncData, AimSyncData * aimSyncData)
@@ -454,7 +459,7 @@ void CPlayer::StoreSmallSync(SmallSyncData * syncPacket, bool bHasAimSyncData, A
 		UpdateWeaponSync(aimSyncData->vecAimTarget,aimSyncData->vecShotSource,aimSyncData->vecLookAt);
 	}
 
-	// Send the sync to all other players
+	// Send the sync to all other players near us
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_playerId);
 	bsSend.Write((char *)syncPacket, sizeof(SmallSyncData));
@@ -464,7 +469,7 @@ void CPlayer::StoreSmallSync(SmallSyncData * syncPacket, bool bHasAimSyncData, A
 	{
 		// Write a 1 bit to say we have aim sync
 		bsSend.Write1();
-		bsSend.Write((char *)aimSyncData, sizeof(AimSyncData));
+		bsSend.Write(*aimSyncData);
 	}
 	else
 	{
@@ -472,7 +477,76 @@ void CPlayer::StoreSmallSync(SmallSyncData * syncPacket, bool bHasAimSyncData, A
 		bsSend.Write0();
 	}
 
-	g_pNetworkManager->RPC(RPC_SmallSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, m_playerId, true);
+	BroadcastSync(RPC_SmallSync, &bsSend);
+}
+
+void CPlayer::UpdateGridPosition()
+{
+	// Update our cell in the player spatial grid
+	g_pPlayerManager->GetSpatialGrid()->Update(m_playerId, m_vecPosition);
+}
+
+void CPlayer::SetSyncRadius(float fSyncRadius)
+{
+	// A negative (or invalid) sync radius means use the sync radius setting, otherwise keep it in the range of the setting
+	if(!(fSyncRadius >= 0.0f))
+		m_fSyncRadius = -1.0f;
+	else
+		m_fSyncRadius = Math::Clamp(0.0f, fSyncRadius, MAX_SYNC_RADIUS);
+}
+
+float CPlayer::GetSyncRadius()
+{
+	// Use the sync radius setting if we don't have our own
+	if(m_fSyncRadius < 0.0f)
+		return g_pNetworkManager->GetSyncRadius();
+
+	return m_fSyncRadius;
+}
+
+void CPlayer::BroadcastSync(RPCIdentifier rpcId, CBitStream * pBitStream)
+{
+	float fQueryRadius = g_pNetworkManager->GetSyncQueryRadius();
+
+	// Reuse the neighbour list so we don't allocate it for every sync
+	static std::vector<EntityId> neighbours;
+	neighbours.clear();
+
+	// If a player wants sync from everywhere consider all players in our dimension,
+	// otherwise only the players whose cell neighbourhood contains us
+	if(fQueryRadius <= 0.0f)
+	{
+		std::set<EntityId> * pPlayers = g_pPlayerManager->GetDimensionPlayers(m_ucDimension);
+		neighbours.assign(pPlayers->begin(), pPlayers->end());
+	}
+	else
+		g_pPlayerManager->GetSpatialGrid()->GetNeighbours(m_vecPosition, fQueryRadius, neighbours);
+
+	// Send the sync to the ones in our dimension which are due an update at their distance
+	for(std::vector<EntityId>::iterator iter = neighbours.begin(); iter != neighbours.end(); iter++)
+	{
+		if(*iter == m_playerId)
+			continue;
+
+		CPlayer * pPlayer = g_pPlayerManager->GetAt(*iter);
+
+		if(!pPlayer || pPlayer->GetDimension() != m_ucDimension)
+			continue;
+
+		CVector3 vecPosition;
+		pPlayer->GetPosition(vecPosition);
+		float fDistance = (vecPosition - m_vecPosition).Length();
+
+		// Are we outside of the sync radius of the player?
+		float fRadius = pPlayer->GetSyncRadius();
+
+		if(fRadius > 0.0f && fDistance > fRadius)
+			continue;
+
+		// Queue the sync, it gets sent with the rest of this ticks sync for the player
+		if(g_pNetworkManager->ShouldSendSync(m_playerId, *iter, fDistance))
+			g_pNetworkManager->QueueSync(rpcId, pBitStream, *iter);
+	}
 }
 
 void CPlayer::Process()
@@ -557,6 +631,7 @@ void CPlayer::SetCameraLookAt(const CVector3& vecPosition)
 void CPlayer::SetPosition(const CVector3& vecPosition)
 {
 	m_vecPosition = vecPosition;
+	UpdateGridPosition();
 	CBitStream bsSend;
 	bsSend.Write(vecPosition);
 	g_pNetworkManager->RPC(RPC_ScriptingSetPlayerCoordinates, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_playerId, false);
@@ -729,8 +804,10 @@ void CPlayer::SetControlState(CControlState * controlState)
 		{
 			CSquirrelArguments pArguments;
 			pArguments.push(m_playerId);
-			g_pEvents->Call("playerChangePadState", &pArguments);
-			g_pEvents->Call("playerChangeControlState", &pArguments);
+			static EventId changePadStateEvent = g_pEvents->GetEventId("playerChangePadState");
+			static EventId changeControlStateEvent = g_pEvents->GetEventId("playerChangeControlState");
+			g_pEvents->Call(changePadStateEvent, &pArguments);
+			g_pEvents->Call(changeControlStateEvent, &pArguments);
 		}
 	}
 }
@@ -869,12 +946,14 @@ void CPlayer::UpdateHeadMoveSync(CVector3 vecHead)
 		m_vecLastHeadMove = vecHead;
 
 		// Call the event
-		g_pEvents->Call("headMove", &pArguments);
+		static EventId headMoveEvent = g_pEvents->GetEventId("headMove");
+		g_pEvents->Call(headMoveEvent, &pArguments);
 	}
 }
 
 void CPlayer::SetDimension(unsigned char ucDimension)
 {
+	g_pPlayerManager->SetPlayerDimension(m_playerId, m_ucDimension, ucDimension);
 	m_ucDimension = ucDimension;
 	CBitStream bsSend;
 	bsSend.Write(this->GetPlayerId());
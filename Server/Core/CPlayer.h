@@ -12,6 +12,8 @@
 #include "Main.h"
 #include "Interfaces/InterfaceCommon.h"
 #include "CVehicle.h"
+#include <Network/CBitStream.h>
+#include <Network/RPCIdentifiers.h>
 
 class CPlayer : public CPlayerInterface
 {
@@ -52,6 +54,10 @@ private:
 	unsigned char m_ucDimension;
 	bool		  m_bDrop;
 	unsigned int  m_iWantedLevel;
+	float         m_fSyncRadius;
+
+	void           UpdateGridPosition();
+	void           BroadcastSync(RPCIdentifier rpcId, CBitStream * pBitStream);
 
 public:
 	CPlayer(EntityId playerId, String strName);
@@ -134,4 +140,7 @@ public:
 
 	void		   SetWantedLevel(int iWantedLevel) { m_iWantedLevel = iWantedLevel; }
 	int			   GetWantedLevel() { return m_iWantedLevel; }
+
+	void           SetSyncRadius(float fSyncRadius);
+	float          GetSyncRadius();
 };
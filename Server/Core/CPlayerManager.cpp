@@ -20,6 +20,7 @@
 #include "CModuleManager.h"
 #include "CEvents.h"
 #include "CBlipManager.h"
+#include <CSettings.h>
 
 extern CNetworkManager * g_pNetworkManager;
 extern CScriptingManager * g_pScriptingManager;
@@ -30,8 +31,20 @@ extern CBlipManager * g_pBlipManager;
 
 CPlayerManager::CPlayerManager()
 {
-	for(EntityId x = 0; x < MAX_PLAYERS; x++)
-		m_bActive[x] = false;
+	// Size the player slots from the max players setting
+	EntityId maxPlayers = (EntityId)CVAR_GET_INTEGER("maxplayers");
+	m_bActive.resize(maxPlayers, false);
+	m_pPlayers.resize(maxPlayers, NULL);
+	m_activePlayerIndex.resize(maxPlayers, 0);
+	m_activePlayers.reserve(maxPlayers);
+
+	// Make the player grid cells as big as the sync radius so a sync neighbourhood is at most 3x3 cells
+	float fCellSize = CVAR_GET_FLOAT("syncradius");
+
+	if(fCellSize <= 0.0f)
+		fCellSize = PLAYER_GRID_CELL_SIZE;
+
+	m_pSpatialGrid = new CSpatialGrid(fCellSize);
 
 	g_pScriptingManager->RegisterConstant("STATE_TYPE_DISCONNECT", STATE_TYPE_DISCONNECT);
 	g_pScriptingManager->RegisterConstant("STATE_TYPE_CONNECT", STATE_TYPE_CONNECT);
@@ -46,16 +59,15 @@ CPlayerManager::CPlayerManager()
 
 CPlayerManager::~CPlayerManager()
 {
-	for(EntityId x = 0; x < MAX_PLAYERS; x++)
-	{
-		if(DoesExist(x))
-			Remove(x, 0);
-	}
+	while(!m_activePlayers.empty())
+		Remove(m_activePlayers.back(), 0);
+
+	SAFE_DELETE(m_pSpatialGrid);
 }
 
 bool CPlayerManager::DoesExist(EntityId playerId)
 {
-	if(playerId < 0 || playerId >= MAX_PLAYERS)
+	if(playerId >= m_bActive.size())
 		return false;
 
 	return m_bActive[playerId];
@@ -63,16 +75,30 @@ bool CPlayerManager::DoesExist(EntityId playerId)
 
 void CPlayerManager::Add(EntityId playerId, String sPlayerName)
 {
+	if(playerId >= m_pPlayers.size())
+		return;
+
 	if(DoesExist(playerId))
 		Remove(playerId, 3);
 
 	m_pPlayers[playerId] = new CPlayer(playerId, sPlayerName);
 
+	// Start a new sync schedule for this player
+	g_pNetworkManager->ResetSyncSchedule(playerId);
+
 	if(m_pPlayers[playerId])
 	{
 		m_bActive[playerId] = true;
+		m_activePlayerIndex[playerId] = (unsigned int)m_activePlayers.size();
+		m_activePlayers.push_back(playerId);
+		m_dimensionPlayers[m_pPlayers[playerId]->GetDimension()].insert(playerId);
 		m_pPlayers[playerId]->AddForWorld();
 		m_pPlayers[playerId]->SetState(STATE_TYPE_CONNECT);
+
+		// Add the player to the spatial grid so it gets sync before it has spawned
+		CVector3 vecPosition;
+		m_pPlayers[playerId]->GetPosition(vecPosition);
+		m_pSpatialGrid->Update(playerId, vecPosition);
 	}
 }
 
@@ -98,6 +124,19 @@ bool CPlayerManager::Remove(EntityId playerId, BYTE byteReason)
 	// Mark player as false
 	m_bActive[playerId] = false;
 
+	// Remove the player from the active players (swap with the last active player)
+	unsigned int uiIndex = m_activePlayerIndex[playerId];
+	EntityId lastPlayerId = m_activePlayers.back();
+	m_activePlayers[uiIndex] = lastPlayerId;
+	m_activePlayerIndex[lastPlayerId] = uiIndex;
+	m_activePlayers.pop_back();
+
+	// Remove the player from the spatial grid
+	m_pSpatialGrid->Remove(playerId);
+
+	// Remove the player from its dimension
+	m_dimensionPlayers[m_pPlayers[playerId]->GetDimension()].erase(playerId);
+
 	String strReason = "None";
 
 	if(byteReason == 0)
@@ -120,20 +159,36 @@ bool CPlayerManager::Remove(EntityId playerId, BYTE byteReason)
 
 void CPlayerManager::Pulse()
 {
-	for(EntityId x = 0; x < MAX_PLAYERS; x++)
+	// Players can be removed while we process them (which moves the last active player
+	// into their place) so process a copy of the active players
+	m_pulsePlayers.assign(m_activePlayers.begin(), m_activePlayers.end());
+
+	for(size_t i = 0; i < m_pulsePlayers.size(); i++)
 	{
-		if(m_bActive[x])
-			m_pPlayers[x]->Process();
+		if(DoesExist(m_pulsePlayers[i]))
+			m_pPlayers[m_pulsePlayers[i]]->Process();
 	}
 }
 
+void CPlayerManager::SetPlayerDimension(EntityId playerId, unsigned char ucOldDimension, unsigned char ucDimension)
+{
+	if(!DoesExist(playerId))
+		return;
+
+	// Move the player to its new dimension
+	m_dimensionPlayers[ucOldDimension].erase(playerId);
+	m_dimensionPlayers[ucDimension].insert(playerId);
+}
+
 void CPlayerManager::HandleClientJoin(EntityId playerId)
 {
 	if(GetPlayerCount() > 1)
  	{
-		for(EntityId x = 0; x < MAX_PLAYERS; x++)
+		for(size_t i = 0; i < m_activePlayers.size(); i++)
 		{
-			if(m_bActive[x] && x != playerId)
+			EntityId x = m_activePlayers[i];
+
+			if(x != playerId)
 			{
 				m_pPlayers[x]->AddForPlayer(playerId);
 				m_pPlayers[x]->SpawnForPlayer(playerId);
@@ -168,13 +223,10 @@ bool CPlayerManager::IsNameInUse(char * sNick)
 
 EntityId CPlayerManager::GetPlayerFromName(String sNick)
 {
-	for(EntityId x = 0; x < MAX_PLAYERS; x++)
+	for(size_t i = 0; i < m_activePlayers.size(); i++)
 	{
-		if(m_bActive[x])
-		{
-			if(!stricmp(m_pPlayers[x]->GetName(), sNick)) 
-				return x;
-		}
+		if(!stricmp(m_pPlayers[m_activePlayers[i]]->GetName(), sNick)) 
+			return m_activePlayers[i];
 	}
 
 	return INVALID_ENTITY_ID;
@@ -187,15 +239,7 @@ EntityId CPlayerManager::GetPlayerFromName(char * sNick)
 
 EntityId CPlayerManager::GetPlayerCount()
 {
-	EntityId playerCount = 0;
-
-	for(EntityId x = 0; x < MAX_PLAYERS; x++)
-	{
-		if(m_bActive[x])
-			playerCount++;
-	}
-
-	return playerCount;
+	return (EntityId)m_activePlayers.size();
 }
 
 CPlayer * CPlayerManager::GetAt(EntityId playerId)
@@ -13,12 +13,26 @@
 #include "Main.h"
 #include "Interfaces/InterfaceCommon.h"
 #include "CPlayer.h"
+#include "CSpatialGrid.h"
+#include <set>
+#include <vector>
+
+// Size of the cells in the player spatial grid if there is no sync radius
+#define PLAYER_GRID_CELL_SIZE 200.0f
+
+// Amount of dimensions (dimensions are stored as an unsigned char)
+#define MAX_DIMENSIONS 256
 
 class CPlayerManager : public CPlayerManagerInterface
 {
 private:
-	bool m_bActive[MAX_PLAYERS];
-	CPlayer * m_pPlayers[MAX_PLAYERS];
+	std::vector<bool> m_bActive;
+	std::vector<CPlayer *> m_pPlayers;
+	std::vector<EntityId> m_activePlayers;
+	std::vector<EntityId> m_pulsePlayers;
+	std::vector<unsigned int> m_activePlayerIndex;
+	CSpatialGrid * m_pSpatialGrid;
+	std::set<EntityId> m_dimensionPlayers[MAX_DIMENSIONS];
 
 public:
 	CPlayerManager();
@@ -35,5 +49,10 @@ public:
 	EntityId GetPlayerFromName(String sNick);
 	EntityId GetPlayerFromName(char * sNick);
 	EntityId GetPlayerCount();
+	EntityId GetMaxPlayers() { return (EntityId)m_pPlayers.size(); }
+	std::vector<EntityId> * GetActivePlayers() { return &m_activePlayers; }
 	CPlayer * GetAt(EntityId playerId);
+	CSpatialGrid * GetSpatialGrid() { return m_pSpatialGrid; }
+	void SetPlayerDimension(EntityId playerId, unsigned char ucOldDimension, unsigned char ucDimension);
+	std::set<EntityId> * GetDimensionPlayers(unsigned char ucDimension) { return &m_dimensionPlayers[ucDimension]; }
 };
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <CEvents.h>
 #include <SharedUtility.h>
 #include "CPlayerManager.h"
+#include "CNetworkManager.h"
 #include <CLogFile.h>
 #ifdef _LINUX
 #include <sys/socket.h>
@@ -26,6 +27,7 @@ typedef int socklen_t;
 
 extern CEvents        * g_pEvents;
 extern CPlayerManager * g_pPlayerManager;
+extern CNetworkManager * g_pNetworkManager;
 
 CQuery::CQuery(unsigned short usPort, String strHostAddress)
 {
@@ -191,37 +193,37 @@ void CQuery::Process()
 					// Write the player count
 					reply.Write(g_pPlayerManager->GetPlayerCount());
 
-					// Loop through all players
-					for(int x = (MAX_PLAYERS - 1); x >= 0; x--)
+					// Loop through all connected players
+					std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+					for(size_t i = 0; i < pPlayers->size(); i++)
 					{
-						// Check if the current player is connected
-						if(g_pPlayerManager->DoesExist(x))
-						{	
-							CPlayer * pPlayer = g_pPlayerManager->GetAt(x);
-
-							if(pPlayer)
-							{
-								// Write the player id
-								reply.Write(x);
-
-								// Write the name
-								reply.Write(pPlayer->GetName());
-
-								// Write the player ping
-								reply.Write(pPlayer->GetPing());
-
-								// Get the players vehicle
-								CVehicle * pVehicle = pPlayer->GetVehicle();
-
-								// Is in the player in a vehicle?
-								if(pVehicle)
-									reply.Write(pVehicle->GetVehicleId());
-								else
-									reply.Write((EntityId)INVALID_ENTITY_ID);
-
-								// Write the player weapon
-								reply.Write(pPlayer->GetWeapon());
-							}
+						int x = (*pPlayers)[i];
+
+						CPlayer * pPlayer = g_pPlayerManager->GetAt(x);
+
+						if(pPlayer)
+						{
+							// Write the player id
+							reply.Write(x);
+
+							// Write the name
+							reply.Write(pPlayer->GetName());
+
+							// Write the player ping
+							reply.Write(pPlayer->GetPing());
+
+							// Get the players vehicle
+							CVehicle * pVehicle = pPlayer->GetVehicle();
+
+							// Is in the player in a vehicle?
+							if(pVehicle)
+								reply.Write(pVehicle->GetVehicleId());
+							else
+								reply.Write((EntityId)INVALID_ENTITY_ID);
+
+							// Write the player weapon
+							reply.Write(pPlayer->GetWeapon());
 						}
 					}
 				}
@@ -247,6 +249,41 @@ void CQuery::Process()
 						reply.Write(pRule->strValue);
 					}
 				}
+				else if(cQueryType == 'n') // Player Net Stats
+				{
+					// Write 'IVMP' and the query type
+					reply.Write(szIdentifier, sizeof(szIdentifier));
+					reply.Write(cQueryType);
+
+					// Write the player count
+					reply.Write(g_pPlayerManager->GetPlayerCount());
+
+					// Loop through all connected players
+					std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+					for(size_t i = 0; i < pPlayers->size(); i++)
+					{
+						CNetStats netStats;
+
+						// Get the players net stats
+						if(!g_pNetworkManager->GetPlayerNetStats((*pPlayers)[i], &netStats))
+							memset(&netStats, 0, sizeof(CNetStats));
+
+						// Write the player id
+						reply.Write((int)(*pPlayers)[i]);
+
+						// Write the bytes sent and received over the last second
+						reply.Write((unsigned int)netStats.ulValueOverLastSecond[ACTUAL_BYTES_SENT]);
+						reply.Write((unsigned int)netStats.ulValueOverLastSecond[ACTUAL_BYTES_RECEIVED]);
+
+						// Write the total bytes sent and received
+						reply.Write((unsigned int)netStats.ulRunningTotal[ACTUAL_BYTES_SENT]);
+						reply.Write((unsigned int)netStats.ulRunningTotal[ACTUAL_BYTES_RECEIVED]);
+
+						// Write the packet loss
+						reply.Write(netStats.fPacketlossTotal);
+					}
+				}
 				else if(cQueryType == 'v') // Version
 				{
 					// Write 'IVMP' and the query type
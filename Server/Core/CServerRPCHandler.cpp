@@ -25,6 +25,7 @@
 #include "CEvents.h"
 #include "CNetworkManager.h"
 #include "CVehicle.h"
+#include "CWorldSnapshot.h"
 
 extern CNetworkManager * g_pNetworkManager;
 extern CScriptingManager * g_pScriptingManager;
@@ -42,6 +43,7 @@ extern CTrafficLights * g_pTrafficLights;
 extern CModuleManager * g_pModuleManager;
 extern CEvents * g_pEvents;
 extern CVehicle * g_pVehicle;
+extern CWorldSnapshot * g_pWorldSnapshot;
 
 void CServerRPCHandler::PlayerConnect(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
 {
@@ -122,29 +124,19 @@ void CServerRPCHandler::PlayerConnect(CBitStream * pBitStream, CPlayerSocket * p
 	if(!pPlayer)
 		return;
 
-	// Let the vehicle manager handle the client join
-	g_pVehicleManager->HandleClientJoin(playerId);
+	// Send the vehicles (players can be in them so they have to come first)
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_VEHICLES, playerId);
 
 	// Let the player manager handle the client join
 	g_pPlayerManager->HandleClientJoin(playerId);
 
-	// Let the object manager handle the client join
-	g_pObjectManager->HandleClientJoin(playerId);
-
-	// Let the fire manager handle the client join
-	g_pObjectManager->HandleClientJoinFire(playerId);
-
-	// Let the blip manager handle the client join
-	g_pBlipManager->HandleClientJoin(playerId);
-
-	// Let the checkpoint manager handle the client join
-	g_pCheckpointManager->HandleClientJoin(playerId);
-
-	// Let the pickup manager handle the client join
-	g_pPickupManager->HandleClientJoin(playerId);
-
-	// Let the actor manager handle the client join
-	g_pActorManager->HandleClientJoin(playerId);
+	// Send the rest of the world (objects and blips can be attached to players)
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_OBJECTS, playerId);
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_FIRES, playerId);
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_BLIPS, playerId);
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_CHECKPOINTS, playerId);
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_PICKUPS, playerId);
+	g_pWorldSnapshot->SendSection(WORLD_SNAPSHOT_ACTORS, playerId);
 
 	// Construct the reply bit stream
 	bsSend.Write(playerId);
@@ -374,21 +366,24 @@ void CServerRPCHandler::OnFootSync(CBitStream * pBitStream, CPlayerSocket * pSen
 			CSquirrelArguments pArguments;
 			pArguments.push(playerId);
 
-			if(g_pEvents->Call("playerOnFootSyncReceived", &pArguments).GetInteger() != 1 || g_pEvents->Call("playerSyncReceived", &pArguments).GetInteger() != 1)
+			static EventId onFootSyncReceivedEvent = g_pEvents->GetEventId("playerOnFootSyncReceived");
+			static EventId syncReceivedEvent = g_pEvents->GetEventId("playerSyncReceived");
+
+			if(g_pEvents->Call(onFootSyncReceivedEvent, &pArguments).GetInteger() != 1 || g_pEvents->Call(syncReceivedEvent, &pArguments).GetInteger() != 1)
 				return;
 		}
 
 		OnFootSyncData syncPacket;
 		AimSyncData aimSyncData;
 
-		if(!pBitStream->Read((char *)&syncPacket, sizeof(OnFootSyncData)))
+		if(!pBitStream->Read(syncPacket))
 			return;
 
 		bool bHasAimSyncData = pBitStream->ReadBit();
 
 		if(bHasAimSyncData)
 		{
-			if(!pBitStream->Read((char *)&aimSyncData, sizeof(AimSyncData)))
+			if(!pBitStream->Read(aimSyncData))
 				return;
 		}
 
@@ -412,7 +407,10 @@ void CServerRPCHandler::InVehicleSync(CBitStream * pBitStream, CPlayerSocket * p
 			CSquirrelArguments pArguments;
 			pArguments.push(playerId);
 
-			if(g_pEvents->Call("playerInVehicleSyncReceived", &pArguments).GetInteger() != 1 || g_pEvents->Call("playerSyncReceived", &pArguments).GetInteger() != 1)
+			static EventId inVehicleSyncReceivedEvent = g_pEvents->GetEventId("playerInVehicleSyncReceived");
+			static EventId syncReceivedEvent = g_pEvents->GetEventId("playerSyncReceived");
+
+			if(g_pEvents->Call(inVehicleSyncReceivedEvent, &pArguments).GetInteger() != 1 || g_pEvents->Call(syncReceivedEvent, &pArguments).GetInteger() != 1)
 				return;
 		}
 
@@ -425,14 +423,14 @@ void CServerRPCHandler::InVehicleSync(CBitStream * pBitStream, CPlayerSocket * p
 
 		if(g_pVehicleManager->DoesExist(vehicleId))
 		{
-			if(!pBitStream->Read((char *)&syncPacket, sizeof(InVehicleSyncData)))
+			if(!pBitStream->Read(syncPacket))
 				return;
 
 			bool bHasAimSyncData = pBitStream->ReadBit();
 
 			if(bHasAimSyncData)
 			{
-				if(!pBitStream->Read((char *)&aimSyncData, sizeof(AimSyncData)))
+				if(!pBitStream->Read(aimSyncData))
 					return;
 			}
 
@@ -448,6 +446,33 @@ void CServerRPCHandler::InVehicleSync(CBitStream * pBitStream, CPlayerSocket * p
 	}
 }
 
+void CServerRPCHandler::VehicleState(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
+{
+	// Ensure we have a valid bit stream
+	if(!pBitStream)
+		return;
+
+	CPlayer * pPlayer = g_pPlayerManager->GetAt(pSenderSocket->playerId);
+
+	if(pPlayer)
+	{
+		EntityId vehicleId;
+		VehicleStateData stateData;
+
+		if(!pBitStream->ReadCompressed(vehicleId))
+			return;
+
+		if(!pBitStream->Read(stateData))
+			return;
+
+		CVehicle * pVehicle = g_pVehicleManager->GetAt(vehicleId);
+
+		// Only accept the vehicle state from the vehicle driver
+		if(pVehicle && pVehicle->GetDriver() == pPlayer)
+			pVehicle->StoreVehicleState(&stateData);
+	}
+}
+
 void CServerRPCHandler::PassengerSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
 {
 	// Ensure we have a valid bit stream
@@ -464,7 +489,10 @@ void CServerRPCHandler::PassengerSync(CBitStream * pBitStream, CPlayerSocket * p
 			CSquirrelArguments pArguments;
 			pArguments.push(playerId);
 
-			if(g_pEvents->Call("playerPassengerSyncReceived", &pArguments).GetInteger() != 1 || g_pEvents->Call("playerSyncReceived", &pArguments).GetInteger() != 1)
+			static EventId passengerSyncReceivedEvent = g_pEvents->GetEventId("playerPassengerSyncReceived");
+			static EventId syncReceivedEvent = g_pEvents->GetEventId("playerSyncReceived");
+
+			if(g_pEvents->Call(passengerSyncReceivedEvent, &pArguments).GetInteger() != 1 || g_pEvents->Call(syncReceivedEvent, &pArguments).GetInteger() != 1)
 				return;
 		}
 
@@ -484,7 +512,7 @@ void CServerRPCHandler::PassengerSync(CBitStream * pBitStream, CPlayerSocket * p
 
 			if(bHasAimSyncData)
 			{
-				if(!pBitStream->Read((char *)&aimSyncData, sizeof(AimSyncData)))
+				if(!pBitStream->Read(aimSyncData))
 					return;
 			}
 
@@ -515,7 +543,10 @@ void CServerRPCHandler::SmallSync(CBitStream * pBitStream, CPlayerSocket * pSend
 			CSquirrelArguments pArguments;
 			pArguments.push(playerId);
 
-			if(g_pEvents->Call("playerSmallSyncReceived", &pArguments).GetInteger() != 1 || g_pEvents->Call("playerSyncReceived", &pArguments).GetInteger() != 1)
+			static EventId smallSyncReceivedEvent = g_pEvents->GetEventId("playerSmallSyncReceived");
+			static EventId syncReceivedEvent = g_pEvents->GetEventId("playerSyncReceived");
+
+			if(g_pEvents->Call(smallSyncReceivedEvent, &pArguments).GetInteger() != 1 || g_pEvents->Call(syncReceivedEvent, &pArguments).GetInteger() != 1)
 				return;
 		}
 
@@ -529,7 +560,7 @@ void CServerRPCHandler::SmallSync(CBitStream * pBitStream, CPlayerSocket * pSend
 
 		if(bHasAimSyncData)
 		{
-			if(!pBitStream->Read((char *)&aimSyncData, sizeof(AimSyncData)))
+			if(!pBitStream->Read(aimSyncData))
 				return;
 		}
 
@@ -769,7 +800,7 @@ void CServerRPCHandler::HeadMovement(CBitStream * pBitStream, CPlayerSocket * pS
 		if(pPlayer)
 		{
 			pPlayer->UpdateHeadMoveSync(vecAim);
-			g_pNetworkManager->RPC(RPC_HeadMovement, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, INVALID_ENTITY_ID, true);
+			g_pNetworkManager->RPCToDimension(RPC_HeadMovement, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, pPlayer->GetDimension());
 		}
 	}
 }
@@ -787,7 +818,10 @@ void CServerRPCHandler::EmptyVehicleSync(CBitStream * pBitStream, CPlayerSocket
 		CSquirrelArguments pArguments;
 		pArguments.push(playerId);
 
-		if(g_pEvents->Call("playerEmptyVehicleSyncReceived", &pArguments).GetInteger() != 1 || g_pEvents->Call("playerSyncReceived", &pArguments).GetInteger() != 1)
+		static EventId emptyVehicleSyncReceivedEvent = g_pEvents->GetEventId("playerEmptyVehicleSyncReceived");
+		static EventId syncReceivedEvent = g_pEvents->GetEventId("playerSyncReceived");
+
+		if(g_pEvents->Call(emptyVehicleSyncReceivedEvent, &pArguments).GetInteger() != 1 || g_pEvents->Call(syncReceivedEvent, &pArguments).GetInteger() != 1)
 			return;
 	}
 
@@ -872,21 +906,17 @@ void CServerRPCHandler::EventCall(CBitStream * pBitStream, CPlayerSocket * pSend
 	if(!pBitStream)
 		return;
 
-	CSquirrelArguments* pArgs = new CSquirrelArguments(pBitStream);
-	CSquirrelArgument* pEventName = pArgs->size() > 0 ? pArgs->front() : 0;
+	CSquirrelArguments arguments(pBitStream);
+	CSquirrelArgument* pEventName = arguments.size() > 0 ? arguments.front() : 0;
 
 	if(pEventName && pEventName->GetType() == OT_STRING)
 	{
-		String strEventName = pEventName->data.str->C_String();
-		pArgs->pop_front();
-		pArgs->push_front(new CSquirrelArgument(pSenderSocket->playerId));
-
-		g_pEvents->Call(strEventName, pArgs);
+		// Replace the event name with the player id
+		String strEventName = pEventName->GetString();
+		pEventName->SetInteger(pSenderSocket->playerId);
 
-		delete pEventName;
+		g_pEvents->Call(strEventName, &arguments);
 	}
-
-	delete pArgs;
 }
 
 void CServerRPCHandler::VehicleDeath(CBitStream * pBitStream, CPlayerSocket * pSenderSocket)
@@ -918,22 +948,22 @@ void CServerRPCHandler::VehicleDeath(CBitStream * pBitStream, CPlayerSocket * pS
 			g_pNetworkManager->RPC(RPC_ScriptingRemovePlayerFromVehicle,&bsSend,PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 		}
 		// Loop trough all players
-		for(EntityId i = 0; i < MAX_PLAYERS; i++)
+		std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+		for(size_t x = 0; x < pPlayers->size(); x++)
 		{
-			if(g_pPlayerManager->DoesExist(i))
+			EntityId i = (*pPlayers)[x];
+
+			if(!g_pPlayerManager->GetAt(i)->IsOnFoot())
 			{
-				if(!g_pPlayerManager->GetAt(i)->IsOnFoot())
+				if(g_pPlayerManager->GetAt(i)->GetVehicle()->GetVehicleId() == pVehicle->GetVehicleId())
 				{
-					if(g_pPlayerManager->GetAt(i)->GetVehicle()->GetVehicleId() == pVehicle->GetVehicleId())
-					{
-						CBitStream bsSend;
-						bsSend.Write(i);
-						bsSend.Write0();
-						g_pNetworkManager->RPC(RPC_ScriptingRemovePlayerFromVehicle,&bsSend,PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, i, false);
-					}
+					CBitStream bsSend;
+					bsSend.Write(i);
+					bsSend.Write0();
+					g_pNetworkManager->RPC(RPC_ScriptingRemovePlayerFromVehicle,&bsSend,PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, i, false);
 				}
 			}
-
 		}
 		pVehicle->SetDeathTime(SharedUtility::GetTime());
 	}
@@ -991,6 +1021,7 @@ void CServerRPCHandler::Register()
 	AddFunction(RPC_Death, Death);
 	AddFunction(RPC_OnFootSync, OnFootSync);
 	AddFunction(RPC_InVehicleSync, InVehicleSync);
+	AddFunction(RPC_VehicleState, VehicleState);
 	AddFunction(RPC_PassengerSync, PassengerSync);
 	AddFunction(RPC_SmallSync, SmallSync);
 	AddFunction(RPC_VehicleEnterExit, VehicleEnterExit);
@@ -1014,6 +1045,7 @@ void CServerRPCHandler::Unregister()
 	RemoveFunction(RPC_Death);
 	RemoveFunction(RPC_OnFootSync);
 	RemoveFunction(RPC_InVehicleSync);
+	RemoveFunction(RPC_VehicleState);
 	RemoveFunction(RPC_PassengerSync);
 	RemoveFunction(RPC_SmallSync);
 	RemoveFunction(RPC_VehicleEnterExit);
@@ -21,6 +21,7 @@ private:
 	static void Death(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void OnFootSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void InVehicleSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
+	static void VehicleState(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void PassengerSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void SmallSync(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 	static void VehicleEnterExit(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
@@ -0,0 +1,153 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CSpatialGrid.cpp
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CSpatialGrid.h"
+#include <math.h>
+
+CSpatialGrid::CSpatialGrid(float fCellSize)
+{
+	// Make sure the cell size is valid
+	if(fCellSize < 1.0f)
+		fCellSize = 1.0f;
+
+	m_fCellSize = fCellSize;
+}
+
+CSpatialGrid::~CSpatialGrid()
+{
+
+}
+
+int CSpatialGrid::GetCellCoordinate(float fPosition)
+{
+	float fCell = floor(fPosition / m_fCellSize);
+
+	// Keep the cell in the range of the cell keys (positions can be anything the client sent us)
+	if(fCell != fCell)
+		return 0;
+
+	if(fCell < -32768.0f)
+		return -32768;
+
+	if(fCell > 32767.0f)
+		return 32767;
+
+	return (int)fCell;
+}
+
+unsigned int CSpatialGrid::GetCellKey(int iCellX, int iCellY)
+{
+	// Pack both cell coordinates into one key (16 bits each)
+	return ((((unsigned int)(iCellX + 0x8000) & 0xFFFF) << 16) | ((unsigned int)(iCellY + 0x8000) & 0xFFFF));
+}
+
+void CSpatialGrid::RemoveFromCell(EntityId entityId, unsigned int uiCell)
+{
+	std::unordered_map<unsigned int, std::vector<EntityId> >::iterator iter = m_cells.find(uiCell);
+
+	if(iter == m_cells.end())
+		return;
+
+	std::vector<EntityId>& entities = iter->second;
+
+	for(size_t i = 0; i < entities.size(); i++)
+	{
+		if(entities[i] == entityId)
+		{
+			// Swap with the last entity and remove that instead
+			entities[i] = entities.back();
+			entities.pop_back();
+			break;
+		}
+	}
+
+	// Don't keep empty cells around
+	if(entities.empty())
+		m_cells.erase(iter);
+}
+
+void CSpatialGrid::Update(EntityId entityId, const CVector3& vecPosition)
+{
+	// Make sure we have an entry for this entity
+	if(entityId >= m_entries.size())
+	{
+		GridEntry entry;
+		entry.bActive = false;
+		entry.uiCell = 0;
+		m_entries.resize(entityId + 1, entry);
+	}
+
+	GridEntry& entry = m_entries[entityId];
+	unsigned int uiCell = GetCellKey(GetCellCoordinate(vecPosition.fX), GetCellCoordinate(vecPosition.fY));
+
+	// Has the entity stayed in the same cell?
+	if(entry.bActive && entry.uiCell == uiCell)
+		return;
+
+	// Remove the entity from its old cell
+	if(entry.bActive)
+		RemoveFromCell(entityId, entry.uiCell);
+
+	// Add the entity to its new cell
+	m_cells[uiCell].push_back(entityId);
+	entry.bActive = true;
+	entry.uiCell = uiCell;
+}
+
+void CSpatialGrid::Remove(EntityId entityId)
+{
+	if(!IsInGrid(entityId))
+		return;
+
+	RemoveFromCell(entityId, m_entries[entityId].uiCell);
+	m_entries[entityId].bActive = false;
+}
+
+bool CSpatialGrid::IsInGrid(EntityId entityId)
+{
+	return (entityId < m_entries.size() && m_entries[entityId].bActive);
+}
+
+void CSpatialGrid::GetNeighbours(const CVector3& vecPosition, float fRadius, std::vector<EntityId>& neighbours)
+{
+	// Get the cells the radius around the position covers
+	int iMinX = GetCellCoordinate(vecPosition.fX - fRadius);
+	int iMaxX = GetCellCoordinate(vecPosition.fX + fRadius);
+	int iMinY = GetCellCoordinate(vecPosition.fY - fRadius);
+	int iMaxY = GetCellCoordinate(vecPosition.fY + fRadius);
+
+	// If there are less occupied cells than cells in the neighbourhood check the occupied cells instead
+	unsigned long long ullCells = ((unsigned long long)(iMaxX - iMinX + 1) * (unsigned long long)(iMaxY - iMinY + 1));
+
+	if((unsigned long long)m_cells.size() < ullCells)
+	{
+		for(std::unordered_map<unsigned int, std::vector<EntityId> >::iterator iter = m_cells.begin(); iter != m_cells.end(); iter++)
+		{
+			int x = ((int)(iter->first >> 16) - 0x8000);
+			int y = ((int)(iter->first & 0xFFFF) - 0x8000);
+
+			if(x >= iMinX && x <= iMaxX && y >= iMinY && y <= iMaxY)
+				neighbours.insert(neighbours.end(), iter->second.begin(), iter->second.end());
+		}
+
+		return;
+	}
+
+	// Collect the entities from all cells in the neighbourhood
+	for(int x = iMinX; x <= iMaxX; x++)
+	{
+		for(int y = iMinY; y <= iMaxY; y++)
+		{
+			std::unordered_map<unsigned int, std::vector<EntityId> >::iterator iter = m_cells.find(GetCellKey(x, y));
+
+			if(iter != m_cells.end())
+				neighbours.insert(neighbours.end(), iter->second.begin(), iter->second.end());
+		}
+	}
+}
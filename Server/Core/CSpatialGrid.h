@@ -0,0 +1,45 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CSpatialGrid.h
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include "Main.h"
+#include <Common.h>
+#include <Math/CVector3.h>
+#include <unordered_map>
+#include <vector>
+
+// Uniform 2D grid of entities used to find out who is near to who
+class CSpatialGrid
+{
+private:
+	struct GridEntry
+	{
+		bool         bActive;
+		unsigned int uiCell;
+	};
+
+	float                                                  m_fCellSize;
+	std::vector<GridEntry>                                 m_entries;
+	std::unordered_map<unsigned int, std::vector<EntityId> > m_cells;
+
+	int          GetCellCoordinate(float fPosition);
+	unsigned int GetCellKey(int iCellX, int iCellY);
+	void         RemoveFromCell(EntityId entityId, unsigned int uiCell);
+
+public:
+	CSpatialGrid(float fCellSize);
+	~CSpatialGrid();
+
+	float        GetCellSize() { return m_fCellSize; }
+	void         Update(EntityId entityId, const CVector3& vecPosition);
+	void         Remove(EntityId entityId);
+	bool         IsInGrid(EntityId entityId);
+	void         GetNeighbours(const CVector3& vecPosition, float fRadius, std::vector<EntityId>& neighbours);
+};
@@ -0,0 +1,113 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CTickProfiler.cpp
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CTickProfiler.h"
+#include <SharedUtility.h>
+#include <algorithm>
+
+static const char * szPhaseNames[TICK_PHASE_COUNT] =
+{
+	"network",
+	"vehicles",
+	"query",
+	"masterlist",
+	"timers",
+	"modules",
+	"serverpulse",
+	"console",
+	"syncflush",
+	"idlenetwork",
+	"total"
+};
+
+CTickProfiler::CTickProfiler()
+{
+	for(int i = 0; i < TICK_PHASE_COUNT; i++)
+		m_ullStartTime[i] = 0;
+
+	// Reset the samples
+	Reset();
+}
+
+CTickProfiler::~CTickProfiler()
+{
+
+}
+
+void CTickProfiler::Start(eTickPhase phase)
+{
+	// Store the phase start time
+	m_ullStartTime[phase] = SharedUtility::GetTimeMicroseconds();
+}
+
+void CTickProfiler::Stop(eTickPhase phase)
+{
+	// Store the time the phase took
+	AddSample(phase, (unsigned int)(SharedUtility::GetTimeMicroseconds() - m_ullStartTime[phase]));
+}
+
+void CTickProfiler::AddSample(eTickPhase phase, unsigned int uiTime)
+{
+	// Store the time in the next sample slot
+	m_uiSamples[phase][m_uiNextSample[phase]] = uiTime;
+
+	// Move to the next sample slot, wrapping around at the end of the window
+	m_uiNextSample[phase] = ((m_uiNextSample[phase] + 1) % TICK_PROFILER_WINDOW);
+
+	if(m_uiSampleCount[phase] < TICK_PROFILER_WINDOW)
+		m_uiSampleCount[phase]++;
+}
+
+void CTickProfiler::Reset()
+{
+	// Only drop the samples, the reset can happen while phases are being timed (tickstats reset runs
+	// in the console phase) and their start times are needed when they stop
+	for(int i = 0; i < TICK_PHASE_COUNT; i++)
+	{
+		m_uiSampleCount[i] = 0;
+		m_uiNextSample[i] = 0;
+	}
+}
+
+bool CTickProfiler::GetStats(eTickPhase phase, TickPhaseStats * pStats)
+{
+	unsigned int uiSampleCount = m_uiSampleCount[phase];
+
+	// Do we have any samples for this phase?
+	if(uiSampleCount == 0)
+		return false;
+
+	// Copy the samples so we can sort them
+	unsigned int uiSamples[TICK_PROFILER_WINDOW];
+	unsigned long long ullTotal = 0;
+
+	for(unsigned int i = 0; i < uiSampleCount; i++)
+	{
+		uiSamples[i] = m_uiSamples[phase][i];
+		ullTotal += uiSamples[i];
+	}
+
+	std::sort(uiSamples, (uiSamples + uiSampleCount));
+
+	// Fill in the stats
+	pStats->uiSamples = uiSampleCount;
+	pStats->uiMin = uiSamples[0];
+	pStats->uiAverage = (unsigned int)(ullTotal / uiSampleCount);
+	pStats->uiP99 = uiSamples[((uiSampleCount - 1) * 99) / 100];
+	pStats->uiMax = uiSamples[uiSampleCount - 1];
+	return true;
+}
+
+const char * CTickProfiler::GetPhaseName(eTickPhase phase)
+{
+	if(phase < 0 || phase >= TICK_PHASE_COUNT)
+		return "unknown";
+
+	return szPhaseNames[phase];
+}
@@ -0,0 +1,59 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CTickProfiler.h
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+// Amount of samples we keep for each phase
+#define TICK_PROFILER_WINDOW 1024
+
+enum eTickPhase
+{
+	TICK_PHASE_NETWORK,
+	TICK_PHASE_VEHICLES,
+	TICK_PHASE_QUERY,
+	TICK_PHASE_MASTERLIST,
+	TICK_PHASE_TIMERS,
+	TICK_PHASE_MODULES,
+	TICK_PHASE_SERVERPULSE,
+	TICK_PHASE_CONSOLE,
+	TICK_PHASE_SYNCFLUSH,
+	TICK_PHASE_IDLENETWORK, // Packets processed while waiting for the next tick (not part of the total)
+	TICK_PHASE_TOTAL,
+	TICK_PHASE_COUNT
+};
+
+struct TickPhaseStats
+{
+	unsigned int uiSamples;
+	unsigned int uiMin;
+	unsigned int uiAverage;
+	unsigned int uiP99;
+	unsigned int uiMax;
+};
+
+class CTickProfiler
+{
+private:
+	unsigned long long m_ullStartTime[TICK_PHASE_COUNT];
+	unsigned int       m_uiSamples[TICK_PHASE_COUNT][TICK_PROFILER_WINDOW];
+	unsigned int       m_uiSampleCount[TICK_PHASE_COUNT];
+	unsigned int       m_uiNextSample[TICK_PHASE_COUNT];
+
+public:
+	CTickProfiler();
+	~CTickProfiler();
+
+	void               Start(eTickPhase phase);
+	void               Stop(eTickPhase phase);
+	void               AddSample(eTickPhase phase, unsigned int uiTime);
+	void               Reset();
+	bool               GetStats(eTickPhase phase, TickPhaseStats * pStats);
+
+	static const char * GetPhaseName(eTickPhase phase);
+};
@@ -0,0 +1,102 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CTickScheduler.cpp
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CTickScheduler.h"
+#include "CNetworkManager.h"
+#include <SharedUtility.h>
+
+extern CNetworkManager * g_pNetworkManager;
+
+CTickScheduler::CTickScheduler(unsigned int uiTickRate)
+{
+	// Set the tick rate
+	SetTickRate(uiTickRate);
+
+	// Reset the tick times
+	m_ullNextTickTime = SharedUtility::GetTimeMicroseconds();
+	m_ullTickStartTime = m_ullNextTickTime;
+	m_ullLastTickTime = 0;
+
+	// Reset the counters
+	m_uiTickCount = 0;
+	m_uiOverrunCount = 0;
+	m_uiEarlyWakeupCount = 0;
+}
+
+CTickScheduler::~CTickScheduler()
+{
+
+}
+
+void CTickScheduler::SetTickRate(unsigned int uiTickRate)
+{
+	// Make sure the tick rate is valid
+	if(uiTickRate == 0)
+		uiTickRate = 1;
+
+	// Set the tick rate and calculate the tick interval (in microseconds)
+	m_uiTickRate = uiTickRate;
+	m_ullTickInterval = (1000000 / uiTickRate);
+}
+
+void CTickScheduler::BeginTick()
+{
+	// Store the tick start time
+	m_ullTickStartTime = SharedUtility::GetTimeMicroseconds();
+}
+
+void CTickScheduler::EndTick()
+{
+	unsigned long long ullTime = SharedUtility::GetTimeMicroseconds();
+
+	// Store the time this tick took
+	m_ullLastTickTime = (ullTime - m_ullTickStartTime);
+
+	// Increment the tick count
+	m_uiTickCount++;
+
+	// Schedule the next tick from the last deadline rather than
+	// from the current time so the tick rate does not drift
+	m_ullNextTickTime += m_ullTickInterval;
+
+	// Have we already missed the next deadline?
+	if(ullTime > m_ullNextTickTime)
+	{
+		// Increment the overrun count
+		m_uiOverrunCount++;
+
+		// Don't try and catch up on the ticks we missed, just start again from now
+		m_ullNextTickTime = ullTime;
+	}
+	else if(m_ullNextTickTime > (ullTime + m_ullTickInterval))
+	{
+		// Ticks ran early (e.g. a fast packet replay) so don't let the next deadline run ahead of now
+		m_ullNextTickTime = (ullTime + m_ullTickInterval);
+	}
+}
+
+bool CTickScheduler::Wait()
+{
+	unsigned long long ullTime = SharedUtility::GetTimeMicroseconds();
+
+	// Is the next tick due?
+	if(ullTime >= m_ullNextTickTime)
+		return false;
+
+	// Get the time left until the next tick (rounded up to the next millisecond)
+	unsigned int uiTimeout = (unsigned int)((m_ullNextTickTime - ullTime + 999) / 1000);
+
+	// Wait until the next tick is due or the net server has packets for us
+	if(!g_pNetworkManager->WaitForPackets(uiTimeout))
+		return false;
+
+	// Increment the early wakeup count
+	m_uiEarlyWakeupCount++;
+	return true;
+}
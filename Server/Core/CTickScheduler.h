@@ -0,0 +1,38 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CTickScheduler.h
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+class CTickScheduler
+{
+private:
+	unsigned int       m_uiTickRate;
+	unsigned long long m_ullTickInterval;
+	unsigned long long m_ullNextTickTime;
+	unsigned long long m_ullTickStartTime;
+	unsigned long long m_ullLastTickTime;
+	unsigned int       m_uiTickCount;
+	unsigned int       m_uiOverrunCount;
+	unsigned int       m_uiEarlyWakeupCount;
+
+public:
+	CTickScheduler(unsigned int uiTickRate);
+	~CTickScheduler();
+
+	void               SetTickRate(unsigned int uiTickRate);
+	unsigned int       GetTickRate() { return m_uiTickRate; }
+	unsigned int       GetTickInterval() { return (unsigned int)m_ullTickInterval; }
+	void               BeginTick();
+	void               EndTick();
+	bool               Wait();
+	unsigned int       GetLastTickTime() { return (unsigned int)m_ullLastTickTime; }
+	unsigned int       GetTickCount() { return m_uiTickCount; }
+	unsigned int       GetOverrunCount() { return m_uiOverrunCount; }
+	unsigned int       GetEarlyWakeupCount() { return m_uiEarlyWakeupCount; }
+};
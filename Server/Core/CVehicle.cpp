@@ -78,6 +78,7 @@ void CVehicle::Reset()
 	m_bTyre[4] = false;
 	m_bTyre[5] = false;
 	m_bGpsState = false;
+	m_usDirtyState = 0;
 }
 
 void CVehicle::SpawnForPlayer(EntityId playerId)
@@ -151,13 +152,32 @@ void CVehicle::SpawnForPlayer(EntityId playerId)
 	else
 		bsSend.Write0();
 
-	g_pNetworkManager->RPC(RPC_NewVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_NewVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_NewVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	// Send the full vehicle state (the new vehicle rpc doesn't contain the tyres)
+	VehicleStateData stateData;
+	GetVehicleState(&stateData, VEHICLE_STATE_ALL);
+	bsSend.Reset();
+	bsSend.WriteCompressed(m_vehicleId);
+	bsSend.Write(stateData);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_VehicleState, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_VehicleState, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 
 	// Mark vehicle as actor vehicle
 	bsSend.Reset();
 	bsSend.Write(m_vehicleId);
 	bsSend.Write(m_bActorVehicle);
-	g_pNetworkManager->RPC(RPC_ScriptingMarkVehicleAsActorVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_ScriptingMarkVehicleAsActorVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_ScriptingMarkVehicleAsActorVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 
 
 	SetColors(m_byteColors[0],m_byteColors[1],m_byteColors[2],m_byteColors[3]);
@@ -167,25 +187,21 @@ void CVehicle::DestroyForPlayer(EntityId playerId)
 {
 	CBitStream bsSend;
 	bsSend.WriteCompressed(m_vehicleId);
-	g_pNetworkManager->RPC(RPC_DeleteVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+
+	if(playerId == INVALID_ENTITY_ID)
+		g_pNetworkManager->RPCToPlayers(RPC_DeleteVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	else
+		g_pNetworkManager->RPC(RPC_DeleteVehicle, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
 }
 
 void CVehicle::SpawnForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			SpawnForPlayer(i);
-	}
+	SpawnForPlayer(INVALID_ENTITY_ID);
 }
 
 void CVehicle::DestroyForWorld()
 {
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(g_pPlayerManager->DoesExist(i))
-			DestroyForPlayer(i);
-	}
+	DestroyForPlayer(INVALID_ENTITY_ID);
 }
 
 bool CVehicle::IsOccupied()
@@ -264,31 +280,113 @@ void CVehicle::StoreInVehicleSync(InVehicleSyncData * syncPacket)
 	}
 	m_uiHealth = syncPacket->uiHealth;
 	m_fPetrolTankHealth = syncPacket->fPetrolHealth;
-	memcpy(m_byteColors, syncPacket->byteColors, sizeof(m_byteColors));
 	memcpy(&m_vecTurnSpeed, &syncPacket->vecTurnSpeed, sizeof(CVector3));
 	memcpy(&m_vecMoveSpeed, &syncPacket->vecMoveSpeed, sizeof(CVector3));
-	m_fDirtLevel = syncPacket->fDirtLevel;
-	m_bSirenState = syncPacket->bSirenState;
-	m_bEngineStatus = syncPacket->bEngineStatus;
-	m_bLights = syncPacket->bLights;
-	m_fDoor[0] = syncPacket->fDoor[0];
-	m_fDoor[1] = syncPacket->fDoor[1];
-	m_fDoor[2] = syncPacket->fDoor[2];
-	m_fDoor[3] = syncPacket->fDoor[3];
-	m_fDoor[4] = syncPacket->fDoor[4];
-	m_fDoor[5] = syncPacket->fDoor[5];
-	m_bWindow[0] = syncPacket->bWindow[0];
-	m_bWindow[1] = syncPacket->bWindow[1];
-	m_bWindow[2] = syncPacket->bWindow[2];
-	m_bWindow[3] = syncPacket->bWindow[3];
-	m_bTaxiLight = syncPacket->bTaxiLights;
-	m_bTyre[0] = syncPacket->bTyre[0];
-	m_bTyre[1] = syncPacket->bTyre[1];
-	m_bTyre[2] = syncPacket->bTyre[2];
-	m_bTyre[3] = syncPacket->bTyre[3];
-	m_bTyre[4] = syncPacket->bTyre[4];
-	m_bTyre[5] = syncPacket->bTyre[5];
-	m_bGpsState = syncPacket->bGpsState;
+}
+
+void CVehicle::StoreVehicleState(VehicleStateData * stateData)
+{
+	// Compare the floats as they are sent, scripts can set them with more precision than the sync carries
+	VehicleStateData currentData;
+	GetVehicleState(&currentData, VEHICLE_STATE_ALL);
+	CBitStream::QuantizeVehicleState(currentData);
+	CBitStream::QuantizeVehicleState(*stateData);
+
+	// Store the states that changed and mark them as dirty
+	if((stateData->usFlags & VEHICLE_STATE_COLORS) && memcmp(m_byteColors, stateData->byteColors, sizeof(m_byteColors)))
+	{
+		memcpy(m_byteColors, stateData->byteColors, sizeof(m_byteColors));
+		m_usDirtyState |= VEHICLE_STATE_COLORS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_DIRT_LEVEL) && currentData.fDirtLevel != stateData->fDirtLevel)
+	{
+		m_fDirtLevel = stateData->fDirtLevel;
+		m_usDirtyState |= VEHICLE_STATE_DIRT_LEVEL;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_DOORS) && memcmp(currentData.fDoor, stateData->fDoor, sizeof(currentData.fDoor)))
+	{
+		memcpy(m_fDoor, stateData->fDoor, sizeof(m_fDoor));
+		m_usDirtyState |= VEHICLE_STATE_DOORS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_ENGINE) && m_bEngineStatus != stateData->bEngineStatus)
+	{
+		m_bEngineStatus = stateData->bEngineStatus;
+		m_usDirtyState |= VEHICLE_STATE_ENGINE;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_LIGHTS) && m_bLights != stateData->bLights)
+	{
+		m_bLights = stateData->bLights;
+		m_usDirtyState |= VEHICLE_STATE_LIGHTS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_TAXI_LIGHTS) && m_bTaxiLight != stateData->bTaxiLights)
+	{
+		m_bTaxiLight = stateData->bTaxiLights;
+		m_usDirtyState |= VEHICLE_STATE_TAXI_LIGHTS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_SIREN) && m_bSirenState != stateData->bSirenState)
+	{
+		m_bSirenState = stateData->bSirenState;
+		m_usDirtyState |= VEHICLE_STATE_SIREN;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_GPS) && m_bGpsState != stateData->bGpsState)
+	{
+		m_bGpsState = stateData->bGpsState;
+		m_usDirtyState |= VEHICLE_STATE_GPS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_WINDOWS) && memcmp(m_bWindow, stateData->bWindow, sizeof(m_bWindow)))
+	{
+		memcpy(m_bWindow, stateData->bWindow, sizeof(m_bWindow));
+		m_usDirtyState |= VEHICLE_STATE_WINDOWS;
+	}
+
+	if((stateData->usFlags & VEHICLE_STATE_TYRES) && memcmp(m_bTyre, stateData->bTyre, sizeof(m_bTyre)))
+	{
+		memcpy(m_bTyre, stateData->bTyre, sizeof(m_bTyre));
+		m_usDirtyState |= VEHICLE_STATE_TYRES;
+	}
+}
+
+void CVehicle::GetVehicleState(VehicleStateData * stateData, unsigned short usFlags)
+{
+	stateData->usFlags = usFlags;
+	memcpy(stateData->byteColors, m_byteColors, sizeof(m_byteColors));
+	stateData->fDirtLevel = m_fDirtLevel;
+	memcpy(stateData->fDoor, m_fDoor, sizeof(m_fDoor));
+	stateData->bEngineStatus = m_bEngineStatus;
+	stateData->bLights = m_bLights;
+	stateData->bTaxiLights = m_bTaxiLight;
+	stateData->bSirenState = m_bSirenState;
+	stateData->bGpsState = m_bGpsState;
+	memcpy(stateData->bWindow, m_bWindow, sizeof(m_bWindow));
+	memcpy(stateData->bTyre, m_bTyre, sizeof(m_bTyre));
+}
+
+void CVehicle::SendStateChanges()
+{
+	// Has any of the vehicle state changed?
+	if(m_usDirtyState == 0)
+		return;
+
+	// Send the changed states to everyone (apart from the driver, they sent them to us), players
+	// in other dimensions still have the vehicle and would keep the old state when they switch over
+	VehicleStateData stateData;
+	GetVehicleState(&stateData, m_usDirtyState);
+
+	CBitStream bsSend;
+	bsSend.WriteCompressed(m_vehicleId);
+	bsSend.Write(stateData);
+	g_pNetworkManager->RPCToPlayers(RPC_VehicleState, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, (m_pDriver ? m_pDriver->GetPlayerId() : INVALID_ENTITY_ID));
+
+	// Reset the dirty states
+	m_usDirtyState = 0;
 }
 
 void CVehicle::StorePassengerSync(PassengerSyncData * syncPacket)
@@ -437,7 +535,7 @@ void CVehicle::SoundHorn(unsigned int iDuration)
 	CBitStream bsSend;
 	bsSend.Write(m_vehicleId);
 	bsSend.Write(iDuration);
-	g_pNetworkManager->RPC(RPC_ScriptingSoundVehicleHorn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, INVALID_ENTITY_ID, true);
+	g_pNetworkManager->RPCToDimension(RPC_ScriptingSoundVehicleHorn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, m_ucDimension);
 }
 
 void CVehicle::SetSirenState(bool bSirenState)
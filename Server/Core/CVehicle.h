@@ -50,6 +50,7 @@ private:
 	int			  m_iRespawnDelay;
 	unsigned long m_lastTimeOccupied;
 	unsigned long m_ulDeathTime;
+	unsigned short m_usDirtyState;
 
 public:
 	CVehicle(EntityId vehicleId, int iModelId, CVector3 vecSpawnPosition, CVector3 vecSpawnRotation, BYTE byteColor1, BYTE byteColor2, BYTE byteColor3, BYTE byteColor4);
@@ -70,6 +71,9 @@ public:
 	CPlayer     * GetOccupant(BYTE byteSeatId);
 	void          Respawn();
 	void          StoreInVehicleSync(InVehicleSyncData * syncPacket);
+	void          StoreVehicleState(VehicleStateData * stateData);
+	void          GetVehicleState(VehicleStateData * stateData, unsigned short usFlags);
+	void          SendStateChanges();
 	void          StorePassengerSync(PassengerSyncData * syncPacket);
 	void		  StoreEmptyVehicle(EMPTYVEHICLESYNCPACKET * syncPacket);
 	void          SetPassengerId(BYTE byteSeatId, EntityId passengerId);
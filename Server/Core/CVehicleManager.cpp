@@ -49,7 +49,8 @@ EntityId CVehicleManager::Add(int iModelId, CVector3 vecSpawnPosition, CVector3
 				m_pVehicles[x]->SetRespawnDelay(respawn_delay);
 				CSquirrelArguments pArguments;
 				pArguments.push(x);
-				g_pEvents->Call("vehicleCreate", &pArguments);
+				static EventId vehicleCreateEvent = g_pEvents->GetEventId("vehicleCreate");
+				g_pEvents->Call(vehicleCreateEvent, &pArguments);
 
 				return x;
 			}
@@ -67,6 +68,9 @@ void CVehicleManager::Process()
 	{
 		if(m_bActive[x])
 		{
+			// Send any vehicle state changes
+			m_pVehicles[x]->SendStateChanges();
+
 			if(m_pVehicles[x]->GetRespawnDelay() > -1) {
 				if(m_pVehicles[x]->IsOccupied()) {
 					m_pVehicles[x]->SetLastTimeOccupied(SharedUtility::GetTime());
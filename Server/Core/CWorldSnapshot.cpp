@@ -0,0 +1,184 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CWorldSnapshot.cpp
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CWorldSnapshot.h"
+#include "CNetworkManager.h"
+#include "CVehicleManager.h"
+#include "CObjectManager.h"
+#include "CBlipManager.h"
+#include "CCheckpointManager.h"
+#include "CPickupManager.h"
+#include "CActorManager.h"
+#include <zlib.h>
+
+extern CNetworkManager    * g_pNetworkManager;
+extern CVehicleManager    * g_pVehicleManager;
+extern CObjectManager     * g_pObjectManager;
+extern CBlipManager       * g_pBlipManager;
+extern CCheckpointManager * g_pCheckpointManager;
+extern CPickupManager     * g_pPickupManager;
+extern CActorManager      * g_pActorManager;
+
+CWorldSnapshot::CWorldSnapshot()
+{
+	for(int i = 0; i < WORLD_SNAPSHOT_SECTION_COUNT; i++)
+	{
+		m_sections[i].uiSizeInBits = 0;
+		m_sections[i].uiRpcCount = 0;
+		m_sections[i].bDirty = true;
+	}
+}
+
+CWorldSnapshot::~CWorldSnapshot()
+{
+
+}
+
+void CWorldSnapshot::HandleClientJoin(eWorldSnapshotSection section, EntityId playerId)
+{
+	// Let the manager of the section handle the client join
+	switch(section)
+	{
+	case WORLD_SNAPSHOT_VEHICLES:
+		g_pVehicleManager->HandleClientJoin(playerId);
+		break;
+	case WORLD_SNAPSHOT_OBJECTS:
+		g_pObjectManager->HandleClientJoin(playerId);
+		break;
+	case WORLD_SNAPSHOT_FIRES:
+		g_pObjectManager->HandleClientJoinFire(playerId);
+		break;
+	case WORLD_SNAPSHOT_BLIPS:
+		g_pBlipManager->HandleClientJoin(playerId);
+		break;
+	case WORLD_SNAPSHOT_CHECKPOINTS:
+		g_pCheckpointManager->HandleClientJoin(playerId);
+		break;
+	case WORLD_SNAPSHOT_PICKUPS:
+		g_pPickupManager->HandleClientJoin(playerId);
+		break;
+	case WORLD_SNAPSHOT_ACTORS:
+		g_pActorManager->HandleClientJoin(playerId);
+		break;
+	default:
+		break;
+	}
+}
+
+bool CWorldSnapshot::UpdateSection(eWorldSnapshotSection section, CBitStream * pBitStream, unsigned int uiRpcCount)
+{
+	SnapshotSection * pSection = &m_sections[section];
+	unsigned int uiSizeInBytes = pBitStream->GetNumberOfBytesUsed();
+
+	// Is the section the same as when we last compressed it?
+	if(pSection->uiSizeInBits == pBitStream->GetNumberOfBitsUsed() && 
+		(uiSizeInBytes == 0 || memcmp(&pSection->data[0], pBitStream->GetData(), uiSizeInBytes) == 0))
+	{
+		return true;
+	}
+
+	// Store the new section data
+	pSection->data.assign(pBitStream->GetData(), (pBitStream->GetData() + uiSizeInBytes));
+	pSection->uiSizeInBits = pBitStream->GetNumberOfBitsUsed();
+	pSection->uiRpcCount = uiRpcCount;
+	pSection->compressedData.clear();
+
+	if(uiSizeInBytes == 0)
+		return true;
+
+	// Compress the section data
+	uLongf ulCompressedSize = compressBound(uiSizeInBytes);
+	pSection->compressedData.resize(ulCompressedSize);
+
+	if(compress(&pSection->compressedData[0], &ulCompressedSize, &pSection->data[0], uiSizeInBytes) != Z_OK)
+	{
+		// Make sure we compress it again next time
+		pSection->data.clear();
+		pSection->uiSizeInBits = 0;
+		pSection->compressedData.clear();
+		return false;
+	}
+
+	pSection->compressedData.resize(ulCompressedSize);
+	return true;
+}
+
+bool CWorldSnapshot::IsCacheable(eWorldSnapshotSection section)
+{
+	// Vehicles are changed by the sync packets and the blips include the player blips
+	return (section != WORLD_SNAPSHOT_VEHICLES && section != WORLD_SNAPSHOT_BLIPS);
+}
+
+void CWorldSnapshot::SendCapturedRpcs(CBitStream * pBitStream, EntityId playerId)
+{
+	RPCIdentifier rpcId;
+	unsigned int uiSizeInBits;
+	CBitStream bsRpc;
+
+	// Send each captured rpc on its own
+	while(pBitStream->Read(rpcId) && pBitStream->ReadCompressed(uiSizeInBits))
+	{
+		bsRpc.Reset();
+
+		if(uiSizeInBits > 0 && !pBitStream->Read(&bsRpc, uiSizeInBits))
+			break;
+
+		g_pNetworkManager->RPC(rpcId, &bsRpc, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+	}
+}
+
+void CWorldSnapshot::SendSection(eWorldSnapshotSection section, EntityId playerId)
+{
+	SnapshotSection * pSection = &m_sections[section];
+
+	// Do we need to serialize the section again?
+	if(pSection->bDirty || !IsCacheable(section))
+	{
+		// Capture the rpcs of the section
+		CBitStream bsCapture;
+		g_pNetworkManager->StartCapture(playerId, &bsCapture);
+		HandleClientJoin(section, playerId);
+		unsigned int uiRpcCount = g_pNetworkManager->StopCapture();
+
+		// Update the section if it changed, if that fails send the captured rpcs uncompressed
+		if(!UpdateSection(section, &bsCapture, uiRpcCount))
+		{
+			SendCapturedRpcs(&bsCapture, playerId);
+			return;
+		}
+
+		pSection->bDirty = false;
+	}
+
+	// Do we have anything to send?
+	if(pSection->uiRpcCount == 0)
+		return;
+
+	// Send the compressed section in chunks
+	unsigned int uiCompressedSize = pSection->compressedData.size();
+	unsigned short usChunkCount = (unsigned short)((uiCompressedSize + WORLD_SNAPSHOT_CHUNK_SIZE - 1) / WORLD_SNAPSHOT_CHUNK_SIZE);
+	CBitStream bsSend;
+
+	for(unsigned short usChunk = 0; usChunk < usChunkCount; usChunk++)
+	{
+		unsigned int uiOffset = (usChunk * WORLD_SNAPSHOT_CHUNK_SIZE);
+		unsigned int uiChunkSize = (uiCompressedSize - uiOffset);
+
+		if(uiChunkSize > WORLD_SNAPSHOT_CHUNK_SIZE)
+			uiChunkSize = WORLD_SNAPSHOT_CHUNK_SIZE;
+
+		bsSend.Reset();
+		bsSend.Write(usChunk);
+		bsSend.Write(usChunkCount);
+		bsSend.Write(pSection->uiRpcCount);
+		bsSend.Write((unsigned int)pSection->data.size());
+		bsSend.Write((char *)&pSection->compressedData[uiOffset], uiChunkSize);
+		g_pNetworkManager->RPC(RPC_WorldSnapshot, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED, playerId, false);
+	}
+}
@@ -0,0 +1,62 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CWorldSnapshot.h
+// Project: Server.Core
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include "Main.h"
+#include <Common.h>
+#include <Network/CBitStream.h>
+#include <vector>
+
+// Max size of each world snapshot chunk (in bytes)
+#define WORLD_SNAPSHOT_CHUNK_SIZE 16384
+
+enum eWorldSnapshotSection
+{
+	WORLD_SNAPSHOT_VEHICLES,
+	WORLD_SNAPSHOT_OBJECTS,
+	WORLD_SNAPSHOT_FIRES,
+	WORLD_SNAPSHOT_BLIPS,
+	WORLD_SNAPSHOT_CHECKPOINTS,
+	WORLD_SNAPSHOT_PICKUPS,
+	WORLD_SNAPSHOT_ACTORS,
+	WORLD_SNAPSHOT_SECTION_COUNT
+};
+
+// Sends the world to joining players as compressed chunks of the rpcs the
+// managers would send. Sections are only serialized again after their manager
+// marked them as dirty, except the vehicles (changed by every sync packet) and
+// the blips (which include the player blips), which are serialized for each
+// join and only compressed again when they changed
+class CWorldSnapshot
+{
+private:
+	struct SnapshotSection
+	{
+		std::vector<unsigned char> data;
+		unsigned int               uiSizeInBits;
+		unsigned int               uiRpcCount;
+		std::vector<unsigned char> compressedData;
+		bool                       bDirty;
+	};
+
+	SnapshotSection m_sections[WORLD_SNAPSHOT_SECTION_COUNT];
+
+	void            HandleClientJoin(eWorldSnapshotSection section, EntityId playerId);
+	bool            UpdateSection(eWorldSnapshotSection section, CBitStream * pBitStream, unsigned int uiRpcCount);
+	void            SendCapturedRpcs(CBitStream * pBitStream, EntityId playerId);
+	bool            IsCacheable(eWorldSnapshotSection section);
+
+public:
+	CWorldSnapshot();
+	~CWorldSnapshot();
+
+	void            MarkDirty(eWorldSnapshotSection section) { m_sections[section].bDirty = true; }
+	void            SendSection(eWorldSnapshotSection section, EntityId playerId);
+};
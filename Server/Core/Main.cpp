@@ -27,6 +27,7 @@
 #include "Natives.h"
 #include "CModuleManager.h"
 #include "Scripting/CScriptTimerManager.h"
+#include "Scripting/CScriptProfiler.h"
 #include "CMasterList.h"
 #include "tinyxml/tinyxml.h"
 #include "tinyxml/ticpp.h"
@@ -40,6 +41,10 @@
 #include <Threading/CMutex.h>
 #include <Threading/CThread.h>
 #include "CQuery.h"
+#include "CTickScheduler.h"
+#include "CTickProfiler.h"
+#include "CAllocationCounter.h"
+#include "CWorldSnapshot.h"
 #include <CExceptionHandler.h>
 #include "ModuleNatives/ModuleNatives.h"
 
@@ -72,8 +77,12 @@ unsigned long        g_ulStartTick = 0;
 CMutex               consoleInputQueueMutex;
 std::queue<String>   consoleInputQueue;
 CQuery             * g_pQuery = NULL;
+CTickScheduler     * g_pTickScheduler = NULL;
+CTickProfiler      * g_pTickProfiler = NULL;
+CWorldSnapshot     * g_pWorldSnapshot = NULL;
 
 extern CScriptTimerManager * g_pScriptTimerManager;
+extern CScriptProfiler * g_pScriptProfiler;
 
 Modules::CActorModuleNatives * g_pActorModuleNatives;
 Modules::CBlipModuleNatives * g_pBlipModuleNatives;
@@ -131,7 +140,7 @@ void SendConsoleInput(String strInput)
 					if(!pScript)
 						CLogFile::Printf("Failed to load script %s (Script does not exist/Script compilation failed).", strParameters.Get());
 					else
-						CLogFile::Printf("Loaded script %s.", strParameters.Get());
+						CLogFile::Printf("Loaded script %s (%s in %llu us).", strParameters.Get(), (pScript->IsFromCache() ? "bytecode cache" : "compiled"), pScript->GetCompileTime());
 				}
 			}
 		}
@@ -226,7 +235,7 @@ void SendConsoleInput(String strInput)
 						pScript = g_pScriptingManager->Load(strParameters, strPath);
 
 						if(pScript)
-							CLogFile::Printf("Reloaded script %s.", strParameters.Get());
+							CLogFile::Printf("Reloaded script %s (%s in %llu us).", strParameters.Get(), (pScript->IsFromCache() ? "bytecode cache" : "compiled"), pScript->GetCompileTime());
 						else
 							CLogFile::Printf("Failed to reload script %s (Failed to load script).", strParameters.Get());
 					}
@@ -294,6 +303,254 @@ void SendConsoleInput(String strInput)
 		{
 			CLogFile::Printf("Server has been online for %s.", SharedUtility::GetTimePassedFromTime(g_ulStartTick).Get());
 		}
+		else if(strCommand == "tickinfo")
+		{
+			CLogFile::Printf("Tick rate: %d tick(s) per second (%d us per tick)", g_pTickScheduler->GetTickRate(), g_pTickScheduler->GetTickInterval());
+			CLogFile::Printf("Ticks: %d (%d overrun, %d early wakeup(s))", g_pTickScheduler->GetTickCount(), g_pTickScheduler->GetOverrunCount(), g_pTickScheduler->GetEarlyWakeupCount());
+			CLogFile::Printf("Last tick took %d us", g_pTickScheduler->GetLastTickTime());
+		}
+		else if(strCommand == "tickstats")
+		{
+			if(strParameters == "reset")
+			{
+				g_pTickProfiler->Reset();
+				CLogFile::Print("Tick stats reset.");
+			}
+			else
+			{
+				CLogFile::Printf("Tick stats (last %d tick(s), times in us):", TICK_PROFILER_WINDOW);
+
+				for(int i = 0; i < TICK_PHASE_COUNT; i++)
+				{
+					TickPhaseStats stats;
+
+					if(g_pTickProfiler->GetStats((eTickPhase)i, &stats))
+						CLogFile::Printf("%-12s min %6d avg %6d p99 %6d max %6d (%d sample(s))", CTickProfiler::GetPhaseName((eTickPhase)i), stats.uiMin, stats.uiAverage, stats.uiP99, stats.uiMax, stats.uiSamples);
+					else
+						CLogFile::Printf("%-12s no samples", CTickProfiler::GetPhaseName((eTickPhase)i));
+				}
+			}
+		}
+		else if(strCommand == "eventbench")
+		{
+			// Time building and calling the arguments of a state change event and of a client event
+			int iCount = (strParameters.IsEmpty() ? 100000 : strParameters.ToInteger());
+
+			if(iCount <= 0)
+				iCount = 1;
+
+			static EventId benchEvent = g_pEvents->GetEventId("eventBench");
+			CBitStream bitStream;
+			CSquirrelArguments clientArguments;
+			clientArguments.push("eventBench");
+			clientArguments.push(1);
+			clientArguments.push("benchmark");
+			clientArguments.push(2.0f);
+			clientArguments.serialize(&bitStream);
+
+			unsigned int uiAllocations = CAllocationCounter::GetCount();
+			unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+
+			for(int i = 0; i < iCount; i++)
+			{
+				CSquirrelArguments pArguments;
+				pArguments.push(i);
+				pArguments.push(1);
+				pArguments.push(2);
+				g_pEvents->Call(benchEvent, &pArguments);
+			}
+
+			unsigned long long ullStateTime = (SharedUtility::GetTimeMicroseconds() - ullStartTime);
+			unsigned int uiStateAllocations = (CAllocationCounter::GetCount() - uiAllocations);
+			uiAllocations = CAllocationCounter::GetCount();
+			ullStartTime = SharedUtility::GetTimeMicroseconds();
+
+			for(int i = 0; i < iCount; i++)
+			{
+				bitStream.ResetReadPointer();
+				CSquirrelArguments pArguments(&bitStream);
+				pArguments.front()->SetInteger(i);
+				g_pEvents->Call(benchEvent, &pArguments);
+			}
+
+			unsigned long long ullClientTime = (SharedUtility::GetTimeMicroseconds() - ullStartTime);
+			unsigned int uiClientAllocations = (CAllocationCounter::GetCount() - uiAllocations);
+			CLogFile::Printf("State event:  %d call(s) %8llu us (%.3f us/call)", iCount, ullStateTime, ((double)ullStateTime / iCount));
+			CLogFile::Printf("Client event: %d call(s) %8llu us (%.3f us/call)", iCount, ullClientTime, ((double)ullClientTime / iCount));
+
+			// The allocations are only counted in servers built with ALLOCATION_COUNTER_ENABLED
+			if(CAllocationCounter::IsEnabled())
+				CLogFile::Printf("Heap allocation(s)/call: state event %.2f, client event %.2f", ((double)uiStateAllocations / iCount), ((double)uiClientAllocations / iCount));
+		}
+		else if(strCommand == "packetstats")
+		{
+			NetPacketStats stats;
+			g_pNetworkManager->GetNetServer()->GetPacketStats(&stats);
+			CLogFile::Printf("Packets received: %d", stats.uiPacketsReceived);
+			CLogFile::Printf("Packets captured: %d replayed: %d", stats.uiPacketsCaptured, stats.uiPacketsReplayed);
+		}
+		else if(strCommand == "packetcapture")
+		{
+			if(strParameters == "stop")
+			{
+				g_pNetworkManager->GetNetServer()->StopPacketCapture();
+				CLogFile::Print("Packet capture stopped.");
+			}
+			else if(strParameters.IsEmpty())
+				CLogFile::Print("Usage: packetcapture <file>|stop");
+			else if(g_pNetworkManager->GetNetServer()->StartPacketCapture(SharedUtility::GetAbsolutePath("%s", strParameters.Get())))
+				CLogFile::Printf("Capturing packets to %s.", strParameters.Get());
+			else
+				CLogFile::Printf("Failed to open %s for packet capture.", strParameters.Get());
+		}
+		else if(strCommand == "packetreplay")
+		{
+			if(strParameters == "stop")
+				g_pNetworkManager->StopPacketReplay();
+			else if(strParameters.IsEmpty())
+				CLogFile::Print("Usage: packetreplay <file> [fast]|stop");
+			else
+			{
+				// Get the file name and the fast flag (if any)
+				String strFileName = strParameters;
+				bool bFast = false;
+				size_t sSplit = strParameters.Find(' ', 0);
+
+				if(sSplit != String::nPos)
+				{
+					strFileName = strParameters.SubStr(0, sSplit);
+					bFast = (strParameters.SubStr(sSplit + 1, String::nPos) == "fast");
+				}
+
+				// The replayed players use the player ids so nobody can be connected during the replay
+				if(g_pPlayerManager->GetPlayerCount() > 0)
+					CLogFile::Print("Packet replay can't be started while players are connected.");
+				else if(!g_pNetworkManager->StartPacketReplay(SharedUtility::GetAbsolutePath("%s", strFileName.Get()), bFast))
+					CLogFile::Printf("Failed to start packet replay of %s (file can't be opened or a player is connecting).", strFileName.Get());
+			}
+		}
+		else if(strCommand == "rpcstats")
+		{
+			CServerPacketHandler * pPacketHandler = g_pNetworkManager->GetPacketHandler();
+			CServerRPCHandler * pRPCHandler = g_pNetworkManager->GetRPCHandler();
+
+			if(strParameters == "reset")
+			{
+				pPacketHandler->ResetStats();
+				pRPCHandler->ResetStats();
+				CLogFile::Print("RPC stats reset.");
+			}
+			else
+			{
+				CLogFile::Print("Packet and RPC stats (times in us):");
+
+				for(int i = 0; i < MAX_PACKET_IDENTIFIERS; i++)
+				{
+					PacketFunction * pFunction = pPacketHandler->GetFunctionFromIdentifier((PacketIdentifier)i);
+
+					if(pFunction && pFunction->uiCallCount > 0)
+						CLogFile::Printf("Packet %3d: %8d call(s) %10llu byte(s) avg %6llu total %10llu", i, pFunction->uiCallCount, pFunction->ullBytes, (pFunction->ullTime / pFunction->uiCallCount), pFunction->ullTime);
+				}
+
+				for(int i = 0; i < MAX_RPC_IDENTIFIERS; i++)
+				{
+					RPCFunction * pFunction = pRPCHandler->GetFunctionFromIdentifier((RPCIdentifier)i);
+
+					if(pFunction && pFunction->uiCallCount > 0)
+						CLogFile::Printf("RPC    %3d: %8d call(s) %10llu byte(s) avg %6llu total %10llu", i, pFunction->uiCallCount, pFunction->ullBytes, (pFunction->ullTime / pFunction->uiCallCount), pFunction->ullTime);
+				}
+			}
+		}
+		else if(strCommand == "netstats")
+		{
+			CServerRPCHandler * pRPCHandler = g_pNetworkManager->GetRPCHandler();
+
+			if(strParameters == "reset")
+			{
+				pRPCHandler->ResetStats();
+				g_pNetworkManager->ResetRPCSendStats();
+				CLogFile::Print("Net stats reset.");
+			}
+			else if(!strParameters.IsEmpty())
+			{
+				// Show the full connection stats of one player
+				EntityId playerId = (EntityId)strParameters.ToInteger();
+				CNetStats netStats;
+
+				if(g_pPlayerManager->DoesExist(playerId) && g_pNetworkManager->GetPlayerNetStats(playerId, &netStats))
+				{
+					char szNetStats[10000];
+					netStats.ToString(szNetStats, 1);
+					CLogFile::Printf("Net stats of player %d (%s):\n%s", playerId, g_pPlayerManager->GetAt(playerId)->GetName().Get(), szNetStats);
+				}
+				else
+					CLogFile::Printf("Player %d is not connected.", playerId);
+			}
+			else
+			{
+				CLogFile::Print("RPC traffic (messages/bytes):");
+
+				for(int i = 0; i < MAX_RPC_IDENTIFIERS; i++)
+				{
+					RPCFunction * pFunction = pRPCHandler->GetFunctionFromIdentifier((RPCIdentifier)i);
+					RPCSendStats * pSendStats = g_pNetworkManager->GetRPCSendStats((RPCIdentifier)i);
+					unsigned int uiCallCount = (pFunction ? pFunction->uiCallCount : 0);
+
+					if(uiCallCount > 0 || pSendStats->uiMessages > 0)
+						CLogFile::Printf("RPC %3d: in %8d %10llu out %8d %10llu", i, uiCallCount, (pFunction ? pFunction->ullBytes : 0), pSendStats->uiMessages, pSendStats->ullBytes);
+				}
+
+				CLogFile::Print("Player traffic (bytes per second sent/received, total sent/received, packet loss):");
+				std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+				for(size_t i = 0; i < pPlayers->size(); i++)
+				{
+					EntityId playerId = (*pPlayers)[i];
+					CNetStats netStats;
+
+					if(g_pNetworkManager->GetPlayerNetStats(playerId, &netStats))
+					{
+						CLogFile::Printf("Player %3d: %8llu %8llu %12llu %12llu %5.1f%%", playerId, netStats.ulValueOverLastSecond[ACTUAL_BYTES_SENT], netStats.ulValueOverLastSecond[ACTUAL_BYTES_RECEIVED], 
+							netStats.ulRunningTotal[ACTUAL_BYTES_SENT], netStats.ulRunningTotal[ACTUAL_BYTES_RECEIVED], (netStats.fPacketlossTotal * 100.0f));
+					}
+				}
+			}
+		}
+		else if(strCommand == "scriptprofile")
+		{
+			if(strParameters == "start")
+			{
+				g_pScriptProfiler->Start();
+				CLogFile::Print("Script profiler started.");
+			}
+			else if(strParameters == "stop")
+			{
+				g_pScriptProfiler->Stop();
+				CLogFile::Printf("Script profiler stopped (%d call(s) in %llu ms).", g_pScriptProfiler->GetCallCount(), (g_pScriptProfiler->GetProfileTime() / 1000));
+			}
+			else if(strParameters.SubStr(0, 4) == "dump")
+			{
+				// Get the file name (if any), the report and the folded stacks are written next to each other
+				String strFileName = "scriptprofile";
+				size_t sSplit = strParameters.Find(' ', 0);
+
+				if(sSplit != String::nPos)
+					strFileName = strParameters.SubStr(sSplit + 1, String::nPos);
+
+				String strReport("%s.txt", strFileName.Get());
+				String strFolded("%s.folded", strFileName.Get());
+
+				if(g_pScriptProfiler->WriteReport(SharedUtility::GetAbsolutePath("%s", strReport.Get())) &&
+					g_pScriptProfiler->WriteFoldedStacks(SharedUtility::GetAbsolutePath("%s", strFolded.Get())))
+				{
+					CLogFile::Printf("Script profile written to %s and %s (%d call(s) in %llu ms).", strReport.Get(), strFolded.Get(), g_pScriptProfiler->GetCallCount(), (g_pScriptProfiler->GetProfileTime() / 1000));
+				}
+				else
+					CLogFile::Printf("Failed to write the script profile to %s.", strFileName.Get());
+			}
+			else
+				CLogFile::Print("Usage: scriptprofile start|stop|dump [file]");
+		}
 		else if(strCommand == "quit" || strCommand == "exit")
 		{
 			g_pNetworkManager->bRunning = false;
@@ -472,9 +729,13 @@ int main(int argc, char ** argv)
 	g_pCheckpointManager = new CCheckpointManager();
 	g_pModuleManager = new CModuleManager();
 	g_pScriptTimerManager = new CScriptTimerManager();
+	g_pScriptProfiler = new CScriptProfiler();
 	g_pWebserver = new CWebServer(CVAR_GET_INTEGER("httpport"));
 	g_pTime = new CTime();
 	g_pTrafficLights = new CTrafficLights();
+	g_pTickScheduler = new CTickScheduler(CVAR_GET_INTEGER("tickrate"));
+	g_pTickProfiler = new CTickProfiler();
+	g_pWorldSnapshot = new CWorldSnapshot();
 
 	g_pPickupModuleNatives = new Modules::CPickupModuleNatives;
 	g_pActorModuleNatives = new Modules::CActorModuleNatives;
@@ -578,19 +839,39 @@ int main(int argc, char ** argv)
 
 	int iResourcesLoaded = 0;
 	int iFailedResources = 0;
+	int iScriptsLoaded = 0;
+	int iCachedScripts = 0;
+	unsigned long long ullCompileTime = 0;
+	unsigned long long ullScriptsStartTime = SharedUtility::GetTimeMicroseconds();
 
 	std::list<String> scripts = CVAR_GET_LIST("script");
 	for(std::list<String>::iterator iter = scripts.begin(); iter != scripts.end(); iter++)
 	{
 		String strPath(SharedUtility::GetAbsolutePath("scripts/%s", (*iter).Get()));
+		CSquirrel * pScript = g_pScriptingManager->Load(*iter, strPath);
 
-		if(!g_pScriptingManager->Load(*iter, strPath))
+		if(!pScript)
 		{
 			CLogFile::Printf("Warning: Failed to load script %s.", (*iter).Get());
 			iFailedResources++;
 		}
 		else
+		{
+			// Keep track of the script load times (to show what the bytecode cache saves)
+			iScriptsLoaded++;
+			ullCompileTime += pScript->GetCompileTime();
+
+			if(pScript->IsFromCache())
+				iCachedScripts++;
+
 			iResourcesLoaded++;
+		}
+	}
+
+	if(iScriptsLoaded > 0)
+	{
+		CLogFile::Printf("Loaded %d script(s) in %llu ms (%d from the bytecode cache, %llu ms compiling/loading bytecode).", iScriptsLoaded, 
+			((SharedUtility::GetTimeMicroseconds() - ullScriptsStartTime) / 1000), iCachedScripts, (ullCompileTime / 1000));
 	}
 
 	std::list<String> clientscripts = CVAR_GET_LIST("clientscript");
@@ -685,23 +966,48 @@ int main(int argc, char ** argv)
 
 	while(g_pNetworkManager->bRunning)
 	{
-		g_pNetworkManager->Process();
+		g_pTickScheduler->BeginTick();
+		g_pTickProfiler->Start(TICK_PHASE_TOTAL);
 
+		g_pTickProfiler->Start(TICK_PHASE_NETWORK);
+		g_pNetworkManager->Process();
+		g_pTickProfiler->Stop(TICK_PHASE_NETWORK);
 
+		g_pTickProfiler->Start(TICK_PHASE_VEHICLES);
 		g_pVehicleManager->Process();
-
+		g_pTickProfiler->Stop(TICK_PHASE_VEHICLES);
 
 		if(g_pQuery)
+		{
+			g_pTickProfiler->Start(TICK_PHASE_QUERY);
 			g_pQuery->Process();
+			g_pTickProfiler->Stop(TICK_PHASE_QUERY);
+		}
 
 		if(g_pMasterList)
+		{
+			g_pTickProfiler->Start(TICK_PHASE_MASTERLIST);
 			g_pMasterList->Pulse();
+			g_pTickProfiler->Stop(TICK_PHASE_MASTERLIST);
+		}
 
+		g_pTickProfiler->Start(TICK_PHASE_TIMERS);
 		g_pScriptTimerManager->Pulse();
+		g_pTickProfiler->Stop(TICK_PHASE_TIMERS);
+
+		g_pTickProfiler->Start(TICK_PHASE_MODULES);
 		g_pModuleManager->Pulse();
+		g_pTickProfiler->Stop(TICK_PHASE_MODULES);
 
 		if(CVAR_GET_BOOL("frequentevents"))
-			g_pEvents->Call("serverPulse");
+		{
+			g_pTickProfiler->Start(TICK_PHASE_SERVERPULSE);
+			static EventId serverPulseEvent = g_pEvents->GetEventId("serverPulse");
+			g_pEvents->Call(serverPulseEvent);
+			g_pTickProfiler->Stop(TICK_PHASE_SERVERPULSE);
+		}
+
+		g_pTickProfiler->Start(TICK_PHASE_CONSOLE);
 
 		// Try and lock the console input queue mutex
 		if(consoleInputQueueMutex.TryLock(0))
@@ -717,7 +1023,26 @@ int main(int argc, char ** argv)
 			consoleInputQueueMutex.Unlock();
 		}
 
-		Sleep(5);
+		g_pTickProfiler->Stop(TICK_PHASE_CONSOLE);
+
+		g_pTickProfiler->Start(TICK_PHASE_SYNCFLUSH);
+		g_pNetworkManager->FlushSyncBatches();
+		g_pTickProfiler->Stop(TICK_PHASE_SYNCFLUSH);
+
+		g_pTickProfiler->Stop(TICK_PHASE_TOTAL);
+		g_pTickScheduler->EndTick();
+
+		// Wait for the next tick, processing any packets which arrive in the meantime
+		unsigned long long ullIdleNetworkTime = 0;
+
+		while(g_pNetworkManager->bRunning && g_pTickScheduler->Wait())
+		{
+			unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+			g_pNetworkManager->Process();
+			ullIdleNetworkTime += (SharedUtility::GetTimeMicroseconds() - ullStartTime);
+		}
+
+		g_pTickProfiler->AddSample(TICK_PHASE_IDLENETWORK, (unsigned int)ullIdleNetworkTime);
 	}
 
 	// Stop the input thread
@@ -732,6 +1057,7 @@ int main(int argc, char ** argv)
 	SAFE_DELETE(g_pMasterList);
 	SAFE_DELETE(g_pQuery);
 	SAFE_DELETE(g_pScriptTimerManager);
+	SAFE_DELETE(g_pScriptProfiler);
 	SAFE_DELETE(g_pModuleManager);
 	SAFE_DELETE(g_pCheckpointManager);
 	SAFE_DELETE(g_pPickupManager);
@@ -748,6 +1074,9 @@ int main(int argc, char ** argv)
 	SAFE_DELETE(g_pWebserver);
 	SAFE_DELETE(g_pTime);
 	SAFE_DELETE(g_pTrafficLights);
+	SAFE_DELETE(g_pTickScheduler);
+	SAFE_DELETE(g_pTickProfiler);
+	SAFE_DELETE(g_pWorldSnapshot);
 	SAFE_DELETE(g_pEvents);
 	CSettings::Close();
 	CLogFile::Close();
@@ -612,7 +612,7 @@ namespace Modules
 				return pPlayer->GetState();
 			}
 		}
-		else if(playerId >= 0 && playerId < MAX_PLAYERS)
+		else if(playerId >= 0 && playerId < g_pPlayerManager->GetMaxPlayers())
 		{
 			return STATE_TYPE_DISCONNECT;
 		}
@@ -107,19 +107,19 @@ namespace Modules
 
 		sq_newtable(pVM);
 
-		for(EntityId i = 0; i < MAX_PLAYERS; i++)
+		std::vector<EntityId> * pActivePlayers = g_pPlayerManager->GetActivePlayers();
+
+		for(size_t i = 0; i < pActivePlayers->size(); i++)
 		{
-			if(g_pPlayerManager->DoesExist(i))
-			{
-				CPlayer * pPlayer = g_pPlayerManager->GetAt(i);
+			EntityId playerId = (*pActivePlayers)[i];
+			CPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
 
-				if(pPlayer)
-				{
-					sq_pushinteger(pVM, i);
-					sq_pushstring(pVM, pPlayer->GetName(), -1);
-					sq_createslot(pVM, -3);
-					++iCount;
-				}
+			if(pPlayer)
+			{
+				sq_pushinteger(pVM, playerId);
+				sq_pushstring(pVM, pPlayer->GetName(), -1);
+				sq_createslot(pVM, -3);
+				++iCount;
 			}
 		}
 
@@ -109,6 +109,7 @@ void CPlayerNatives::Register(CScriptingManager * pScriptingManager)
 	pScriptingManager->RegisterFunction("setPlayerColor", SetColor, 2, "ii");
 	pScriptingManager->RegisterFunction("getPlayerColor", GetColor, 1, "i");
 	pScriptingManager->RegisterFunction("getPlayerPing", GetPing, 1, "i");
+	pScriptingManager->RegisterFunction("getPlayerNetStats", GetNetStats, 1, "i");
 	pScriptingManager->RegisterFunction("givePlayerHelmet", GiveHelmet, 1, "i");
 	pScriptingManager->RegisterFunction("removePlayerHelmet", RemoveHelmet, 1, "i");
 	pScriptingManager->RegisterFunction("togglePlayerHelmet", ToggleHelmet, 2, "ib");
@@ -144,6 +145,8 @@ void CPlayerNatives::Register(CScriptingManager * pScriptingManager)
 	
 	pScriptingManager->RegisterFunction("setPlayerDimension", SetDimension, 2, "ii");
 	pScriptingManager->RegisterFunction("getPlayerDimension", GetDimension, 1, "i");
+	pScriptingManager->RegisterFunction("setPlayerSyncRadius", SetSyncRadius, 2, "if");
+	pScriptingManager->RegisterFunction("getPlayerSyncRadius", GetSyncRadius, 1, "i");
 }
 
 // isPlayerConnected(playerid)
@@ -1085,7 +1088,7 @@ SQInteger CPlayerNatives::GetState(SQVM * pVM)
 			return 1;
 		}
 	}
-	else if(playerId >= 0 && playerId < MAX_PLAYERS)
+	else if(playerId >= 0 && playerId < g_pPlayerManager->GetMaxPlayers())
 	{
 		sq_pushinteger(pVM, STATE_TYPE_DISCONNECT);
 		return 1;
@@ -1846,6 +1849,44 @@ SQInteger CPlayerNatives::GetPing(SQVM* pVM)
 	return 1;
 }
 
+SQInteger CPlayerNatives::GetNetStats(SQVM * pVM)
+{
+	EntityId playerId;
+	sq_getentity(pVM, 2, &playerId);
+
+	CNetStats netStats;
+
+	if(g_pPlayerManager->DoesExist(playerId) && g_pNetworkManager->GetPlayerNetStats(playerId, &netStats))
+	{
+		sq_newtable(pVM);
+		sq_pushstring(pVM, "bytesSentPerSecond", -1);
+		sq_pushinteger(pVM, (SQInteger)netStats.ulValueOverLastSecond[ACTUAL_BYTES_SENT]);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "bytesReceivedPerSecond", -1);
+		sq_pushinteger(pVM, (SQInteger)netStats.ulValueOverLastSecond[ACTUAL_BYTES_RECEIVED]);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "totalBytesSent", -1);
+		sq_pushinteger(pVM, (SQInteger)netStats.ulRunningTotal[ACTUAL_BYTES_SENT]);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "totalBytesReceived", -1);
+		sq_pushinteger(pVM, (SQInteger)netStats.ulRunningTotal[ACTUAL_BYTES_RECEIVED]);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "bytesResent", -1);
+		sq_pushinteger(pVM, (SQInteger)netStats.ulRunningTotal[USER_MESSAGE_BYTES_RESENT]);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "packetLoss", -1);
+		sq_pushfloat(pVM, netStats.fPacketlossLastSecond);
+		sq_createslot(pVM, -3);
+		sq_pushstring(pVM, "averagePacketLoss", -1);
+		sq_pushfloat(pVM, netStats.fPacketlossTotal);
+		sq_createslot(pVM, -3);
+		return 1;
+	}
+
+	sq_pushbool(pVM, false);
+	return 1;
+}
+
 SQInteger CPlayerNatives::SetClothes(SQVM * pVM)
 {
 	SQInteger iPlayerId, iBodyPart, iClothes;
@@ -2587,4 +2628,44 @@ SQInteger CPlayerNatives::GetDimension(SQVM * pVM)
 
 	sq_pushinteger(pVM, -1);
 	return 1;
+}
+
+// setPlayerSyncRadius(playerid, radius)
+// How far away other players may be to send this player their sync (0 for no limit, -1 for the syncradius setting, at most 10000)
+SQInteger CPlayerNatives::SetSyncRadius(SQVM * pVM)
+{
+	EntityId playerId;
+	float fRadius;
+	sq_getentity(pVM, -2, &playerId);
+	sq_getfloat(pVM, -1, &fRadius);
+
+	CPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
+
+	if(pPlayer)
+	{
+		pPlayer->SetSyncRadius(fRadius);
+		sq_pushbool(pVM, true);
+		return 1;
+	}
+
+	sq_pushbool(pVM, false);
+	return 1;
+}
+
+// getPlayerSyncRadius(playerid)
+SQInteger CPlayerNatives::GetSyncRadius(SQVM * pVM)
+{
+	EntityId playerId;
+	sq_getentity(pVM, -1, &playerId);
+
+	CPlayer * pPlayer = g_pPlayerManager->GetAt(playerId);
+
+	if(pPlayer)
+	{
+		sq_pushfloat(pVM, pPlayer->GetSyncRadius());
+		return 1;
+	}
+
+	sq_pushbool(pVM, false);
+	return 1;
 }
\ No newline at end of file
@@ -85,6 +85,7 @@ private:
 	static SQInteger GetColor(SQVM * pVM);
 	static SQInteger SetColor(SQVM * pVM);
 	static SQInteger GetPing(SQVM * pVM);
+	static SQInteger GetNetStats(SQVM * pVM);
 	static SQInteger SetClothes(SQVM * pVM);
 	static SQInteger GetClothes(SQVM * pVM);
 	static SQInteger ResetClothes(SQVM * pVM);
@@ -118,6 +119,8 @@ private:
 
 	static SQInteger SetDimension(SQVM * pVM);
 	static SQInteger GetDimension(SQVM * pVM);
+	static SQInteger SetSyncRadius(SQVM * pVM);
+	static SQInteger GetSyncRadius(SQVM * pVM);
 
 public:
 	static void      Register(CScriptingManager * pScriptingManager);
@@ -18,12 +18,16 @@
 #include "tinyxml/ticpp.h"
 #include <CSettings.h>
 #include "../CQuery.h"
+#include "../CTickScheduler.h"
+#include "../CTickProfiler.h"
 #include <SharedUtility.h>
 
 extern CPlayerManager    * g_pPlayerManager;
 extern CNetworkManager   * g_pNetworkManager;
 extern CQuery            * g_pQuery;
 extern CScriptingManager * g_pScriptingManager;
+extern CTickScheduler    * g_pTickScheduler;
+extern CTickProfiler     * g_pTickProfiler;
 
 void SendConsoleInput(String strInput);
 
@@ -44,6 +48,8 @@ void CServerNatives::Register(CScriptingManager * pScriptingManager)
 	pScriptingManager->RegisterFunction("getPlayers", GetPlayers, 0, NULL);
 	pScriptingManager->RegisterFunction("getPlayerSlots", GetPlayerSlots, 0, NULL);
 	pScriptingManager->RegisterFunction("getTickCount", GetTickCount, 0, NULL);
+	pScriptingManager->RegisterFunction("getServerTickInfo", GetTickInfo, 0, NULL);
+	pScriptingManager->RegisterFunction("getServerTickStats", GetTickStats, 0, NULL);
 	pScriptingManager->RegisterFunction("setHostname", SetHostName, 1, "s");
 	pScriptingManager->RegisterFunction("getHostname", GetHostName, 0, NULL);
 	pScriptingManager->RegisterFunction("togglePayAndSpray", TogglePayAndSpray, 1, "b");
@@ -166,19 +172,18 @@ SQInteger CServerNatives::GetPlayers(SQVM * pVM)
 
 	sq_newtable(pVM);
 
-	for(EntityId i = 0; i < MAX_PLAYERS; i++)
+	std::vector<EntityId> * pPlayers = g_pPlayerManager->GetActivePlayers();
+
+	for(size_t i = 0; i < pPlayers->size(); i++)
 	{
-		if(g_pPlayerManager->DoesExist(i))
-		{
-			CPlayer * pPlayer = g_pPlayerManager->GetAt(i);
+		CPlayer * pPlayer = g_pPlayerManager->GetAt((*pPlayers)[i]);
 
-			if(pPlayer)
-			{
-				sq_pushinteger(pVM, i);
-				sq_pushstring(pVM, pPlayer->GetName(), -1);
-				sq_createslot(pVM, -3);
-				++iCount;
-			}
+		if(pPlayer)
+		{
+			sq_pushinteger(pVM, (*pPlayers)[i]);
+			sq_pushstring(pVM, pPlayer->GetName(), -1);
+			sq_createslot(pVM, -3);
+			++iCount;
 		}
 	}
 
@@ -199,6 +204,75 @@ SQInteger CServerNatives::GetTickCount(SQVM * pVM)
 	return 1;
 }
 
+// getServerTickInfo()
+SQInteger CServerNatives::GetTickInfo(SQVM * pVM)
+{
+	sq_newtable(pVM);
+
+	sq_pushstring(pVM, "tickrate", -1);
+	sq_pushinteger(pVM, g_pTickScheduler->GetTickRate());
+	sq_createslot(pVM, -3);
+
+	sq_pushstring(pVM, "ticks", -1);
+	sq_pushinteger(pVM, g_pTickScheduler->GetTickCount());
+	sq_createslot(pVM, -3);
+
+	sq_pushstring(pVM, "overruns", -1);
+	sq_pushinteger(pVM, g_pTickScheduler->GetOverrunCount());
+	sq_createslot(pVM, -3);
+
+	sq_pushstring(pVM, "earlywakeups", -1);
+	sq_pushinteger(pVM, g_pTickScheduler->GetEarlyWakeupCount());
+	sq_createslot(pVM, -3);
+
+	sq_pushstring(pVM, "lastticktime", -1);
+	sq_pushinteger(pVM, g_pTickScheduler->GetLastTickTime());
+	sq_createslot(pVM, -3);
+	return 1;
+}
+
+// getServerTickStats()
+SQInteger CServerNatives::GetTickStats(SQVM * pVM)
+{
+	sq_newtable(pVM);
+
+	for(int i = 0; i < TICK_PHASE_COUNT; i++)
+	{
+		TickPhaseStats stats;
+
+		// Skip phases which have not run yet
+		if(!g_pTickProfiler->GetStats((eTickPhase)i, &stats))
+			continue;
+
+		sq_pushstring(pVM, CTickProfiler::GetPhaseName((eTickPhase)i), -1);
+		sq_newtable(pVM);
+
+		sq_pushstring(pVM, "min", -1);
+		sq_pushinteger(pVM, stats.uiMin);
+		sq_createslot(pVM, -3);
+
+		sq_pushstring(pVM, "avg", -1);
+		sq_pushinteger(pVM, stats.uiAverage);
+		sq_createslot(pVM, -3);
+
+		sq_pushstring(pVM, "p99", -1);
+		sq_pushinteger(pVM, stats.uiP99);
+		sq_createslot(pVM, -3);
+
+		sq_pushstring(pVM, "max", -1);
+		sq_pushinteger(pVM, stats.uiMax);
+		sq_createslot(pVM, -3);
+
+		sq_pushstring(pVM, "samples", -1);
+		sq_pushinteger(pVM, stats.uiSamples);
+		sq_createslot(pVM, -3);
+
+		sq_createslot(pVM, -3);
+	}
+
+	return 1;
+}
+
 // setHostname(hostname)
 SQInteger CServerNatives::SetHostName(SQVM * pVM)
 {
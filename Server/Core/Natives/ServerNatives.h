@@ -28,6 +28,8 @@ private:
 	static SQInteger GetPlayers(SQVM * pVM);
 	static SQInteger GetPlayerSlots(SQVM * pVM);
 	static SQInteger GetTickCount(SQVM * pVM);
+	static SQInteger GetTickInfo(SQVM * pVM);
+	static SQInteger GetTickStats(SQVM * pVM);
 	static SQInteger SetHostName(SQVM * pVM);
 	static SQInteger GetHostName(SQVM * pVM);
 	static SQInteger TogglePayAndSpray(SQVM * pVM);
@@ -0,0 +1,271 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CLoadTestBot.cpp
+// Project: Server.LoadTest
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CLoadTestBot.h"
+#include <Network/CNetworkModule.h>
+#include <Network/PacketIdentifiers.h>
+#include <Math/CMath.h>
+#include <SharedUtility.h>
+#include <CLogFile.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Position the bot paths are spread around (the default spawn)
+#define BOT_PATH_BASE_X -341.36f
+#define BOT_PATH_BASE_Y 1144.80f
+#define BOT_PATH_BASE_Z 14.79f
+
+// Size of the square the bot paths are spread over (in meters)
+#define BOT_PATH_SPREAD 400.0f
+
+// Walking and driving speed of the bots (in meters per second)
+#define BOT_ON_FOOT_SPEED 5.0f
+#define BOT_IN_VEHICLE_SPEED 20.0f
+
+CLoadTestBot * CLoadTestBot::m_pProcessingBot = NULL;
+
+CLoadTestBot::CLoadTestBot(unsigned int uiBotId, String strName, EntityId vehicleId, unsigned int uiSyncRate)
+{
+	// Set the bot info
+	m_uiBotId = uiBotId;
+	m_strName = strName;
+	m_state = BOT_STATE_IDLE;
+	m_playerId = INVALID_ENTITY_ID;
+	m_vehicleId = vehicleId;
+
+	// Make sure the sync rate is valid
+	if(uiSyncRate == 0)
+		uiSyncRate = 1;
+
+	m_uiSyncInterval = (1000 / uiSyncRate);
+	m_ulNextSyncTime = 0;
+	m_ulConnectTime = 0;
+	m_ulJoinTime = 0;
+
+	// Give each bot its own circular path (seeded from the bot id so runs are repeatable)
+	srand(uiBotId);
+	m_vecPathCenter = CVector3((BOT_PATH_BASE_X + ((((float)rand() / RAND_MAX) - 0.5f) * BOT_PATH_SPREAD)),
+		(BOT_PATH_BASE_Y + ((((float)rand() / RAND_MAX) - 0.5f) * BOT_PATH_SPREAD)), BOT_PATH_BASE_Z);
+	m_fPathRadius = (10.0f + (((float)rand() / RAND_MAX) * 40.0f));
+	m_fPathSpeed = (IsInVehicle() ? BOT_IN_VEHICLE_SPEED : BOT_ON_FOOT_SPEED);
+	m_fPathAngle = (((float)rand() / RAND_MAX) * DOUBLE_PI);
+
+	// Reset the stats
+	m_uiSyncCount = 0;
+	m_uiRpcsReceived = 0;
+	m_ullBytesReceived = 0;
+
+	// Create the net client instance
+	m_pNetClient = CNetworkModule::GetNetClientInterface();
+	m_pNetClient->SetPacketHandler(PacketHandler);
+}
+
+CLoadTestBot::~CLoadTestBot()
+{
+	// Shutdown the net client instance
+	m_pNetClient->Shutdown(500);
+
+	// Delete the net client instance
+	CNetworkModule::DestroyNetClientInterface(m_pNetClient);
+}
+
+bool CLoadTestBot::Connect(String strHost, unsigned short usPort, String strPassword)
+{
+	// Startup the net client
+	if(!m_pNetClient->Startup())
+		return false;
+
+	// Start the connection attempt
+	m_pNetClient->SetHost(strHost);
+	m_pNetClient->SetPort(usPort);
+	m_pNetClient->SetPassword(strPassword);
+
+	if(m_pNetClient->Connect() != CONNECTION_ATTEMPT_STARTED)
+		return false;
+
+	m_state = BOT_STATE_CONNECTING;
+	m_ulConnectTime = SharedUtility::GetTime();
+	return true;
+}
+
+void CLoadTestBot::Disconnect()
+{
+	m_pNetClient->Disconnect();
+	m_state = BOT_STATE_DISCONNECTED;
+}
+
+void CLoadTestBot::PacketHandler(CPacket * pPacket)
+{
+	// The packet handler has no user data so pass the packet to the bot being processed
+	if(m_pProcessingBot)
+		m_pProcessingBot->HandlePacket(pPacket);
+}
+
+void CLoadTestBot::HandlePacket(CPacket * pPacket)
+{
+	switch(pPacket->packetId)
+	{
+	case PACKET_CONNECTION_SUCCEEDED:
+		{
+			// Start the handshake like a real client
+			CBitStream bsSend;
+			bsSend.Write(NETWORK_VERSION);
+			bsSend.Write(m_strName);
+			bsSend.WriteBit(false);
+			m_pNetClient->RPC(RPC_PlayerConnect, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+			m_state = BOT_STATE_AUTHORIZING;
+		}
+		break;
+	case PACKET_RPC:
+		{
+			// Count the rpc
+			m_uiRpcsReceived++;
+			m_ullBytesReceived += pPacket->uiLength;
+
+			// Read the rpc id and pass the rpc on
+			CBitStream bitStream(pPacket->ucData, pPacket->uiLength, false);
+			RPCIdentifier rpcId;
+
+			if(bitStream.Read(rpcId))
+				HandleRPC(rpcId, &bitStream);
+		}
+		break;
+	case PACKET_CONNECTION_REJECTED:
+	case PACKET_CONNECTION_FAILED:
+	case PACKET_ALREADY_CONNECTED:
+	case PACKET_SERVER_FULL:
+	case PACKET_BANNED:
+	case PACKET_PASSWORD_INVALID:
+	case PACKET_DISCONNECTED:
+	case PACKET_LOST_CONNECTION:
+		CLogFile::Printf("Bot %d (%s) lost the connection to the server (Packet %d).", m_uiBotId, m_strName.Get(), pPacket->packetId);
+		m_state = BOT_STATE_DISCONNECTED;
+		break;
+	}
+}
+
+void CLoadTestBot::HandleRPC(RPCIdentifier rpcId, CBitStream * pBitStream)
+{
+	if(rpcId == RPC_JoinedGame)
+	{
+		// The server has accepted us and sent us the world, read our player id
+		if(!pBitStream->Read(m_playerId))
+			return;
+
+		m_state = BOT_STATE_JOINED;
+		m_ulJoinTime = SharedUtility::GetTime();
+
+		// Send the spawn notification like a real client
+		CBitStream bsSend;
+		bsSend.Write(0);
+		m_pNetClient->RPC(RPC_PlayerSpawn, &bsSend, PRIORITY_HIGH, RELIABILITY_RELIABLE_ORDERED);
+	}
+	else if(rpcId == RPC_ConnectionRefused)
+	{
+		int iReason = 0;
+		pBitStream->Read(iReason);
+		CLogFile::Printf("Bot %d (%s) was refused by the server (Reason %d).", m_uiBotId, m_strName.Get(), iReason);
+		Disconnect();
+	}
+}
+
+void CLoadTestBot::Process()
+{
+	// Process the packets of our net client
+	m_pProcessingBot = this;
+	m_pNetClient->Process();
+	m_pProcessingBot = NULL;
+
+	// Have we joined the game?
+	if(m_state != BOT_STATE_JOINED)
+		return;
+
+	// Is our next sync due?
+	unsigned long ulTime = SharedUtility::GetTime();
+
+	if(ulTime < m_ulNextSyncTime)
+		return;
+
+	// Move along the path by the time since the last sync
+	m_fPathAngle += ((m_fPathSpeed / m_fPathRadius) * (m_uiSyncInterval / 1000.0f));
+	m_fPathAngle = Math::WrapAround(m_fPathAngle, DOUBLE_PI);
+
+	if(IsInVehicle())
+		SendInVehicleSync();
+	else
+		SendOnFootSync();
+
+	m_uiSyncCount++;
+	m_ulNextSyncTime = (ulTime + m_uiSyncInterval);
+}
+
+void CLoadTestBot::SendOnFootSync()
+{
+	CBitStream bsSend;
+	OnFootSyncData syncPacket;
+
+	// Get the position and direction on our path
+	float fSin = sin(m_fPathAngle);
+	float fCos = cos(m_fPathAngle);
+	syncPacket.vecPos = CVector3((m_vecPathCenter.fX + (fCos * m_fPathRadius)), (m_vecPathCenter.fY + (fSin * m_fPathRadius)), m_vecPathCenter.fZ);
+	syncPacket.fHeading = (m_fPathAngle + PI);
+	syncPacket.vecMoveSpeed = CVector3((-fSin * m_fPathSpeed), (fCos * m_fPathSpeed), 0.0f);
+	syncPacket.vecTurnSpeed = CVector3();
+	syncPacket.bDuckState = false;
+	syncPacket.uHealthArmour = ((200 << 16) | 0);
+	syncPacket.uWeaponInfo = 0;
+	syncPacket.bAnim = false;
+	bsSend.Write(syncPacket);
+
+	// We don't have aim sync
+	bsSend.Write0();
+	m_pNetClient->RPC(RPC_OnFootSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED);
+}
+
+void CLoadTestBot::SendInVehicleSync()
+{
+	CBitStream bsSend;
+	InVehicleSyncData syncPacket;
+
+	// Write the vehicle id
+	bsSend.WriteCompressed(m_vehicleId);
+
+	// Get the position and direction on our path
+	float fSin = sin(m_fPathAngle);
+	float fCos = cos(m_fPathAngle);
+	syncPacket.vecPos = CVector3((m_vecPathCenter.fX + (fCos * m_fPathRadius)), (m_vecPathCenter.fY + (fSin * m_fPathRadius)), m_vecPathCenter.fZ);
+	syncPacket.vecRotation = CVector3(0.0f, 0.0f, Math::ConvertRadiansToDegrees(m_fPathAngle));
+	syncPacket.uiHealth = 1000;
+	syncPacket.vecTurnSpeed = CVector3(0.0f, 0.0f, (m_fPathSpeed / m_fPathRadius));
+	syncPacket.vecMoveSpeed = CVector3((-fSin * m_fPathSpeed), (fCos * m_fPathSpeed), 0.0f);
+	syncPacket.fPetrolHealth = 1000.0f;
+	syncPacket.uPlayerHealthArmour = ((200 << 16) | 0);
+	syncPacket.uPlayerWeaponInfo = 0;
+	bsSend.Write(syncPacket);
+
+	// We don't have aim sync
+	bsSend.Write0();
+	m_pNetClient->RPC(RPC_InVehicleSync, &bsSend, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED);
+}
+
+void CLoadTestBot::SampleRTT()
+{
+	// Store the round trip time of the connection
+	if(m_state == BOT_STATE_JOINED)
+		m_rttSamples.push_back(m_pNetClient->GetLastPing());
+}
+
+CNetStats * CLoadTestBot::GetNetStats()
+{
+	// Only connected clients have net stats
+	if(!m_pNetClient->IsConnected())
+		return NULL;
+
+	return m_pNetClient->GetNetStats();
+}
@@ -0,0 +1,75 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CLoadTestBot.h
+// Project: Server.LoadTest
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include <Common.h>
+#include <CString.h>
+#include <Math/CVector3.h>
+#include <Network/CNetClientInterface.h>
+#include <vector>
+
+enum eBotState
+{
+	BOT_STATE_IDLE,
+	BOT_STATE_CONNECTING,
+	BOT_STATE_AUTHORIZING,
+	BOT_STATE_JOINED,
+	BOT_STATE_DISCONNECTED
+};
+
+// Fake player that connects to a server and sends sync along a scripted path
+class CLoadTestBot
+{
+private:
+	static CLoadTestBot * m_pProcessingBot;
+
+	CNetClientInterface * m_pNetClient;
+	unsigned int          m_uiBotId;
+	String                m_strName;
+	eBotState             m_state;
+	EntityId              m_playerId;
+	EntityId              m_vehicleId;
+	unsigned int          m_uiSyncInterval;
+	unsigned long         m_ulNextSyncTime;
+	unsigned long         m_ulConnectTime;
+	unsigned long         m_ulJoinTime;
+	CVector3              m_vecPathCenter;
+	float                 m_fPathRadius;
+	float                 m_fPathSpeed;
+	float                 m_fPathAngle;
+	unsigned int          m_uiSyncCount;
+	unsigned int          m_uiRpcsReceived;
+	unsigned long long    m_ullBytesReceived;
+	std::vector<int>      m_rttSamples;
+
+	static void           PacketHandler(CPacket * pPacket);
+	void                  HandlePacket(CPacket * pPacket);
+	void                  HandleRPC(RPCIdentifier rpcId, CBitStream * pBitStream);
+	void                  SendOnFootSync();
+	void                  SendInVehicleSync();
+
+public:
+	CLoadTestBot(unsigned int uiBotId, String strName, EntityId vehicleId, unsigned int uiSyncRate);
+	~CLoadTestBot();
+
+	bool                  Connect(String strHost, unsigned short usPort, String strPassword);
+	void                  Disconnect();
+	void                  Process();
+	void                  SampleRTT();
+	eBotState             GetState() { return m_state; }
+	unsigned int          GetBotId() { return m_uiBotId; }
+	EntityId              GetPlayerId() { return m_playerId; }
+	bool                  IsInVehicle() { return (m_vehicleId != INVALID_ENTITY_ID); }
+	unsigned long         GetJoinDuration() { return (m_ulJoinTime - m_ulConnectTime); }
+	unsigned int          GetSyncCount() { return m_uiSyncCount; }
+	unsigned int          GetRpcsReceived() { return m_uiRpcsReceived; }
+	std::vector<int>    * GetRTTSamples() { return &m_rttSamples; }
+	CNetStats           * GetNetStats();
+};
@@ -0,0 +1,221 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: Main.cpp
+// Project: Server.LoadTest
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+// Headless load generator, connects fake players to a server and sends sync
+// Usage: ivmp-loadtest [-host 127.0.0.1] [-port 9999] [-password ""] [-bots 32]
+//                      [-vehicles 0] [-syncrate 10] [-connectrate 10] [-duration 60]
+
+#include "CLoadTestBot.h"
+#include <Network/CNetworkModule.h>
+#include <SharedUtility.h>
+#include <CLogFile.h>
+#include <algorithm>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct LoadTestSettings
+{
+	String         strHost;
+	unsigned short usPort;
+	String         strPassword;
+	unsigned int   uiBots;
+	unsigned int   uiVehicles;
+	unsigned int   uiSyncRate;
+	unsigned int   uiConnectRate;
+	unsigned int   uiDuration;
+};
+
+void ParseCommandLine(int argc, char ** argv, LoadTestSettings * pSettings)
+{
+	for(int i = 1; (i + 1) < argc; i += 2)
+	{
+		// Get the setting and value
+		const char * szSetting = argv[i];
+		const char * szValue = argv[i + 1];
+
+		if(!strcmp(szSetting, "-host"))
+			pSettings->strHost = szValue;
+		else if(!strcmp(szSetting, "-port"))
+			pSettings->usPort = (unsigned short)atoi(szValue);
+		else if(!strcmp(szSetting, "-password"))
+			pSettings->strPassword = szValue;
+		else if(!strcmp(szSetting, "-bots"))
+			pSettings->uiBots = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-vehicles"))
+			pSettings->uiVehicles = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-syncrate"))
+			pSettings->uiSyncRate = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-connectrate"))
+			pSettings->uiConnectRate = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-duration"))
+			pSettings->uiDuration = (unsigned int)atoi(szValue);
+		else
+			CLogFile::Printf("WARNING: Command line setting %s does not exist.", szSetting);
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	// Set the default settings
+	LoadTestSettings settings;
+	settings.strHost = "127.0.0.1";
+	settings.usPort = 9999;
+	settings.uiBots = 32;
+	settings.uiVehicles = 0;
+	settings.uiSyncRate = (1000 / TICK_RATE);
+	settings.uiConnectRate = 10;
+	settings.uiDuration = 60;
+
+	// Parse the command line
+	ParseCommandLine(argc, argv, &settings);
+
+	if(settings.uiConnectRate == 0)
+		settings.uiConnectRate = 1;
+
+	// Initialize the network module, if it fails, exit
+	if(!CNetworkModule::Init())
+	{
+		CLogFile::Print("Failed to initialize the network module!");
+		return 1;
+	}
+
+	CLogFile::Printf("Connecting %d bot(s) (%d in vehicles) to %s:%d at %d sync(s) per second for %d second(s).", settings.uiBots, settings.uiVehicles,
+		settings.strHost.Get(), settings.usPort, settings.uiSyncRate, settings.uiDuration);
+
+	// Create the bots (the first ones drive vehicles 0 to vehicles - 1)
+	std::vector<CLoadTestBot *> bots;
+
+	for(unsigned int i = 0; i < settings.uiBots; i++)
+	{
+		EntityId vehicleId = ((i < settings.uiVehicles) ? (EntityId)i : INVALID_ENTITY_ID);
+		bots.push_back(new CLoadTestBot(i, String("Bot_%d", i), vehicleId, settings.uiSyncRate));
+	}
+
+	unsigned long ulStartTime = SharedUtility::GetTime();
+	unsigned long ulEndTime = (ulStartTime + (settings.uiDuration * 1000));
+	unsigned long ulNextReportTime = (ulStartTime + 1000);
+	unsigned int uiConnectInterval = (1000 / settings.uiConnectRate);
+	unsigned long ulNextConnectTime = ulStartTime;
+	unsigned int uiNextBot = 0;
+
+	while(SharedUtility::GetTime() < ulEndTime)
+	{
+		unsigned long ulTime = SharedUtility::GetTime();
+
+		// Connect the next bot if it is due (connecting all at once would just measure the handshake)
+		if(uiNextBot < bots.size() && ulTime >= ulNextConnectTime)
+		{
+			if(!bots[uiNextBot]->Connect(settings.strHost, settings.usPort, settings.strPassword))
+				CLogFile::Printf("Bot %d failed to start connecting.", uiNextBot);
+
+			uiNextBot++;
+			ulNextConnectTime += uiConnectInterval;
+		}
+
+		// Process the bots
+		for(size_t i = 0; i < bots.size(); i++)
+			bots[i]->Process();
+
+		// Report the current state every second
+		if(ulTime >= ulNextReportTime)
+		{
+			unsigned int uiJoined = 0;
+			NetStat_t ulBytesSent = 0;
+			NetStat_t ulBytesReceived = 0;
+
+			for(size_t i = 0; i < bots.size(); i++)
+			{
+				bots[i]->SampleRTT();
+
+				if(bots[i]->GetState() == BOT_STATE_JOINED)
+					uiJoined++;
+
+				CNetStats * pNetStats = bots[i]->GetNetStats();
+
+				if(pNetStats)
+				{
+					ulBytesSent += pNetStats->ulValueOverLastSecond[ACTUAL_BYTES_SENT];
+					ulBytesReceived += pNetStats->ulValueOverLastSecond[ACTUAL_BYTES_RECEIVED];
+				}
+			}
+
+			CLogFile::Printf("[%3lus] %d/%d bot(s) joined, %llu byte(s)/s sent, %llu byte(s)/s received", ((ulTime - ulStartTime) / 1000), uiJoined, bots.size(), ulBytesSent, ulBytesReceived);
+			ulNextReportTime += 1000;
+		}
+
+		usleep(1000);
+	}
+
+	// Collect the results
+	unsigned int uiJoined = 0;
+	unsigned long ulJoinTime = 0;
+	unsigned long long ullSyncs = 0;
+	unsigned long long ullRpcs = 0;
+	NetStat_t ulBytesSent = 0;
+	NetStat_t ulBytesReceived = 0;
+	std::vector<int> rttSamples;
+
+	for(size_t i = 0; i < bots.size(); i++)
+	{
+		CLoadTestBot * pBot = bots[i];
+
+		if(pBot->GetState() == BOT_STATE_JOINED)
+		{
+			uiJoined++;
+			ulJoinTime += pBot->GetJoinDuration();
+		}
+
+		ullSyncs += pBot->GetSyncCount();
+		ullRpcs += pBot->GetRpcsReceived();
+		rttSamples.insert(rttSamples.end(), pBot->GetRTTSamples()->begin(), pBot->GetRTTSamples()->end());
+
+		CNetStats * pNetStats = pBot->GetNetStats();
+
+		if(pNetStats)
+		{
+			ulBytesSent += pNetStats->ulRunningTotal[ACTUAL_BYTES_SENT];
+			ulBytesReceived += pNetStats->ulRunningTotal[ACTUAL_BYTES_RECEIVED];
+		}
+	}
+
+	// Print the results
+	CLogFile::Print("====================================================================");
+	CLogFile::Printf("Bots joined: %d/%d (average join time %lums)", uiJoined, bots.size(), (uiJoined ? (ulJoinTime / uiJoined) : 0));
+	CLogFile::Printf("Syncs sent: %llu, rpcs received: %llu", ullSyncs, ullRpcs);
+	CLogFile::Printf("Bytes sent: %llu (%llu/s per bot), bytes received: %llu (%llu/s per bot)", ulBytesSent, (uiJoined ? (ulBytesSent / settings.uiDuration / uiJoined) : 0),
+		ulBytesReceived, (uiJoined ? (ulBytesReceived / settings.uiDuration / uiJoined) : 0));
+
+	if(!rttSamples.empty())
+	{
+		std::sort(rttSamples.begin(), rttSamples.end());
+		long long llTotal = 0;
+
+		for(size_t i = 0; i < rttSamples.size(); i++)
+			llTotal += rttSamples[i];
+
+		CLogFile::Printf("RTT (ms): min %d avg %lld p50 %d p99 %d max %d", rttSamples.front(), (llTotal / (long long)rttSamples.size()),
+			rttSamples[(rttSamples.size() - 1) / 2], rttSamples[((rttSamples.size() - 1) * 99) / 100], rttSamples.back());
+	}
+
+	CLogFile::Print("====================================================================");
+
+	// Disconnect and delete the bots
+	for(size_t i = 0; i < bots.size(); i++)
+	{
+		bots[i]->Disconnect();
+		delete bots[i];
+	}
+
+	// Shutdown the network module
+	CNetworkModule::Shutdown();
+
+	// Fail if not all bots could join
+	return ((uiJoined == bots.size()) ? 0 : 1);
+}
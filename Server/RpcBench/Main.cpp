@@ -0,0 +1,199 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: Main.cpp
+// Project: Server.RpcBench
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+// Rpc send path benchmark, connects a net client to a local net server and
+// times CNetServerInterface::RPC against framing the rpc into a new bit stream
+// and sending that (what RPC did before it used RakPeer::SendList)
+// Usage: ivmp-rpcbench [-port 9998] [-rpcs 100000] [-batch 100]
+
+#include <Network/CNetworkModule.h>
+#include <Network/PacketIdentifiers.h>
+#include <SharedUtility.h>
+#include <CLogFile.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct RpcBenchSettings
+{
+	unsigned short usPort;
+	unsigned int   uiRpcs;
+	unsigned int   uiBatch;
+};
+
+enum eRpcBenchMode
+{
+	RPC_BENCH_MODE_FRAMED,
+	RPC_BENCH_MODE_RPC
+};
+
+unsigned int g_uiClientRpcs = 0;
+bool         g_bClientConnected = false;
+
+void ParseCommandLine(int argc, char ** argv, RpcBenchSettings * pSettings)
+{
+	for(int i = 1; (i + 1) < argc; i += 2)
+	{
+		// Get the setting and value
+		const char * szSetting = argv[i];
+		const char * szValue = argv[i + 1];
+
+		if(!strcmp(szSetting, "-port"))
+			pSettings->usPort = (unsigned short)atoi(szValue);
+		else if(!strcmp(szSetting, "-rpcs"))
+			pSettings->uiRpcs = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-batch"))
+			pSettings->uiBatch = (unsigned int)atoi(szValue);
+		else
+			CLogFile::Printf("WARNING: Command line setting %s does not exist.", szSetting);
+	}
+}
+
+void ServerPacketHandler(CPacket * pPacket)
+{
+
+}
+
+void ClientPacketHandler(CPacket * pPacket)
+{
+	if(pPacket->packetId == PACKET_CONNECTION_SUCCEEDED)
+		g_bClientConnected = true;
+	else if(pPacket->packetId == PACKET_RPC)
+		g_uiClientRpcs++;
+}
+
+// Process the server and client until the client has received all rpcs sent so far (or a second passed)
+void WaitForRpcs(CNetServerInterface * pNetServer, CNetClientInterface * pNetClient, unsigned int uiRpcs)
+{
+	unsigned long ulEndTime = (SharedUtility::GetTime() + 1000);
+
+	while(g_uiClientRpcs < uiRpcs && SharedUtility::GetTime() < ulEndTime)
+	{
+		pNetServer->Process();
+		pNetClient->Process();
+		usleep(100);
+	}
+}
+
+double RunBenchmark(RpcBenchSettings * pSettings, CNetServerInterface * pNetServer, CNetClientInterface * pNetClient, unsigned int uiPayloadSize, eRpcBenchMode mode)
+{
+	// Fill the payload
+	CBitStream bsPayload;
+
+	for(unsigned int i = 0; i < uiPayloadSize; i++)
+		bsPayload.Write((unsigned char)i);
+
+	unsigned long long ullTime = 0;
+	unsigned int uiSent = 0;
+	g_uiClientRpcs = 0;
+
+	while(uiSent < pSettings->uiRpcs)
+	{
+		unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+
+		// Send a batch of rpcs to the client (timed)
+		for(unsigned int i = 0; i < pSettings->uiBatch; i++)
+		{
+			if(mode == RPC_BENCH_MODE_FRAMED)
+			{
+				CBitStream bitStream;
+				bitStream.Write((PacketId)PACKET_RPC);
+				bitStream.Write((RPCIdentifier)RPC_BatchedSync);
+				bitStream.Write((char *)bsPayload.GetData(), bsPayload.GetNumberOfBytesUsed());
+				pNetServer->Send(&bitStream, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, 0, false);
+			}
+			else
+				pNetServer->RPC(RPC_BatchedSync, &bsPayload, PRIORITY_LOW, RELIABILITY_UNRELIABLE_SEQUENCED, 0, false);
+		}
+
+		ullTime += (SharedUtility::GetTimeMicroseconds() - ullStartTime);
+		uiSent += pSettings->uiBatch;
+
+		// Let the client receive them so the send buffers don't grow (not timed)
+		WaitForRpcs(pNetServer, pNetClient, uiSent);
+	}
+
+	CLogFile::Printf("  %s: %d/%d rpc(s) received", ((mode == RPC_BENCH_MODE_FRAMED) ? "framed" : "rpc"), g_uiClientRpcs, uiSent);
+	return ((double)(ullTime * 1000) / uiSent);
+}
+
+int main(int argc, char ** argv)
+{
+	// Set the default settings
+	RpcBenchSettings settings;
+	settings.usPort = 9998;
+	settings.uiRpcs = 100000;
+	settings.uiBatch = 100;
+
+	// Parse the command line
+	ParseCommandLine(argc, argv, &settings);
+
+	if(settings.uiBatch == 0)
+		settings.uiBatch = 1;
+
+	// Initialize the network module, if it fails, exit
+	if(!CNetworkModule::Init())
+	{
+		CLogFile::Print("Failed to initialize the network module!");
+		return 1;
+	}
+
+	// Start the server and connect the client to it
+	CNetServerInterface * pNetServer = CNetworkModule::GetNetServerInterface();
+	CNetClientInterface * pNetClient = CNetworkModule::GetNetClientInterface();
+	pNetServer->SetPacketHandler(ServerPacketHandler);
+	pNetClient->SetPacketHandler(ClientPacketHandler);
+
+	if(!pNetServer->Startup(settings.usPort, 1) || !pNetClient->Startup())
+	{
+		CLogFile::Printf("Failed to start the net server on port %d!", settings.usPort);
+		return 1;
+	}
+
+	pNetClient->SetHost("127.0.0.1");
+	pNetClient->SetPort(settings.usPort);
+	pNetClient->Connect();
+
+	unsigned long ulEndTime = (SharedUtility::GetTime() + 5000);
+
+	while(!g_bClientConnected && SharedUtility::GetTime() < ulEndTime)
+	{
+		pNetServer->Process();
+		pNetClient->Process();
+		usleep(1000);
+	}
+
+	int iResult = 1;
+
+	if(g_bClientConnected)
+	{
+		unsigned int uiPayloadSizes[] = { 32, 300, 1024 };
+
+		CLogFile::Printf("Rpc send cost on the calling thread (%d rpc(s) per payload in batches of %d):", settings.uiRpcs, settings.uiBatch);
+
+		for(unsigned int i = 0; i < (sizeof(uiPayloadSizes) / sizeof(unsigned int)); i++)
+		{
+			double dFramed = RunBenchmark(&settings, pNetServer, pNetClient, uiPayloadSizes[i], RPC_BENCH_MODE_FRAMED);
+			double dRpc = RunBenchmark(&settings, pNetServer, pNetClient, uiPayloadSizes[i], RPC_BENCH_MODE_RPC);
+			CLogFile::Printf("%4d byte payload: framed %.0f ns/rpc, RPC %.0f ns/rpc", uiPayloadSizes[i], dFramed, dRpc);
+		}
+
+		iResult = 0;
+	}
+	else
+		CLogFile::Print("The client failed to connect to the server!");
+
+	// Shutdown the client and server
+	pNetClient->Disconnect();
+	pNetClient->Shutdown(500);
+	pNetServer->Shutdown(500);
+	CNetworkModule::DestroyNetClientInterface(pNetClient);
+	CNetworkModule::DestroyNetServerInterface(pNetServer);
+	CNetworkModule::Shutdown();
+	return iResult;
+}
@@ -0,0 +1,207 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: Main.cpp
+// Project: Server.SyncBench
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+// Synthetic sync fan-out benchmark, times how long finding and queueing the
+// sync recipients of every player takes per tick with the player spatial grid
+// (what the server does) and with a check of all players in the dimension
+// Usage: ivmp-syncbench [-area 4000] [-ticks 500] [-radius 500] [-speed 5]
+
+#include "../Core/CSpatialGrid.h"
+#include <Network/CBitStream.h>
+#include <SharedUtility.h>
+#include <set>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The default sync distance tiers of the server
+#define BENCH_NEAR_DISTANCE 100.0f
+#define BENCH_MID_DISTANCE 250.0f
+#define BENCH_MID_INTERVAL 3
+#define BENCH_FAR_INTERVAL 10
+#define BENCH_BATCH_MAX_SIZE 1024
+
+enum eBenchMode
+{
+	BENCH_MODE_GRID,
+	BENCH_MODE_DIMENSION
+};
+
+struct SyncBenchSettings
+{
+	float        fArea;
+	unsigned int uiTicks;
+	float        fRadius;
+	float        fSpeed;
+};
+
+struct SyncBenchResult
+{
+	double       dMicroseconds;
+	unsigned int uiSyncs;
+};
+
+void ParseCommandLine(int argc, char ** argv, SyncBenchSettings * pSettings)
+{
+	for(int i = 1; (i + 1) < argc; i += 2)
+	{
+		// Get the setting and value
+		const char * szSetting = argv[i];
+		const char * szValue = argv[i + 1];
+
+		if(!strcmp(szSetting, "-area"))
+			pSettings->fArea = (float)atof(szValue);
+		else if(!strcmp(szSetting, "-ticks"))
+			pSettings->uiTicks = (unsigned int)atoi(szValue);
+		else if(!strcmp(szSetting, "-radius"))
+			pSettings->fRadius = (float)atof(szValue);
+		else if(!strcmp(szSetting, "-speed"))
+			pSettings->fSpeed = (float)atof(szValue);
+		else
+			printf("WARNING: Command line setting %s does not exist.\n", szSetting);
+	}
+}
+
+float RandomFloat(float fMin, float fMax)
+{
+	return (fMin + ((float)rand() / RAND_MAX) * (fMax - fMin));
+}
+
+// Same as CNetworkManager::ShouldSendSync
+bool ShouldSendSync(std::vector<unsigned char>& counters, unsigned int uiPlayers, EntityId senderId, EntityId recipientId, float fDistance)
+{
+	unsigned char& ucCounter = counters[(senderId * uiPlayers) + recipientId];
+
+	if(fDistance <= BENCH_NEAR_DISTANCE)
+	{
+		ucCounter = 0;
+		return true;
+	}
+
+	unsigned char ucInterval = ((fDistance <= BENCH_MID_DISTANCE) ? BENCH_MID_INTERVAL : BENCH_FAR_INTERVAL);
+
+	if(++ucCounter < ucInterval)
+		return false;
+
+	ucCounter = 0;
+	return true;
+}
+
+SyncBenchResult RunBenchmark(SyncBenchSettings * pSettings, unsigned int uiPlayers, eBenchMode mode)
+{
+	// Spread the players over the area, every mode gets the same players and movement
+	srand(uiPlayers);
+	std::vector<CVector3> positions(uiPlayers);
+	std::set<EntityId> dimensionPlayers;
+	float fHalfArea = (pSettings->fArea / 2);
+
+	for(unsigned int i = 0; i < uiPlayers; i++)
+	{
+		positions[i] = CVector3(RandomFloat(-fHalfArea, fHalfArea), RandomFloat(-fHalfArea, fHalfArea), 0.0f);
+		dimensionPlayers.insert((EntityId)i);
+	}
+
+	CSpatialGrid grid(pSettings->fRadius);
+	std::vector<unsigned char> counters(uiPlayers * uiPlayers, 0);
+	std::vector<CBitStream> batches(uiPlayers);
+	std::vector<EntityId> neighbours;
+	CBitStream bsSync;
+
+	// About the size of an on foot sync
+	for(int i = 0; i < 6; i++)
+		bsSync.Write(1.0f);
+
+	SyncBenchResult result;
+	result.dMicroseconds = 0;
+	result.uiSyncs = 0;
+
+	for(unsigned int uiTick = 0; uiTick < pSettings->uiTicks; uiTick++)
+	{
+		// Move the players (not timed)
+		for(unsigned int i = 0; i < uiPlayers; i++)
+		{
+			positions[i].fX += RandomFloat(-pSettings->fSpeed, pSettings->fSpeed);
+			positions[i].fY += RandomFloat(-pSettings->fSpeed, pSettings->fSpeed);
+		}
+
+		unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+
+		// Handle the sync of every player like CPlayer::UpdateGridPosition and CPlayer::BroadcastSync
+		for(unsigned int i = 0; i < uiPlayers; i++)
+		{
+			grid.Update((EntityId)i, positions[i]);
+			neighbours.clear();
+
+			if(mode == BENCH_MODE_DIMENSION)
+				neighbours.assign(dimensionPlayers.begin(), dimensionPlayers.end());
+			else
+				grid.GetNeighbours(positions[i], pSettings->fRadius, neighbours);
+
+			for(std::vector<EntityId>::iterator iter = neighbours.begin(); iter != neighbours.end(); iter++)
+			{
+				if(*iter == i)
+					continue;
+
+				float fDistance = (positions[*iter] - positions[i]).Length();
+
+				if(fDistance > pSettings->fRadius)
+					continue;
+
+				if(!ShouldSendSync(counters, uiPlayers, (EntityId)i, *iter, fDistance))
+					continue;
+
+				// Queue the sync in the batch of the recipient like CNetworkManager::QueueSync
+				CBitStream * pBatch = &batches[*iter];
+
+				if((pBatch->GetNumberOfBytesUsed() + bsSync.GetNumberOfBytesUsed() + 3) > BENCH_BATCH_MAX_SIZE)
+					pBatch->Reset();
+
+				pBatch->Write(&bsSync);
+				result.uiSyncs++;
+			}
+		}
+
+		// Flush the batches
+		for(unsigned int i = 0; i < uiPlayers; i++)
+			batches[i].Reset();
+
+		result.dMicroseconds += (double)(SharedUtility::GetTimeMicroseconds() - ullStartTime);
+	}
+
+	result.dMicroseconds /= pSettings->uiTicks;
+	result.uiSyncs /= pSettings->uiTicks;
+	return result;
+}
+
+int main(int argc, char ** argv)
+{
+	SyncBenchSettings settings;
+	settings.fArea = 4000.0f;
+	settings.uiTicks = 500;
+	settings.fRadius = 500.0f;
+	settings.fSpeed = 5.0f;
+	ParseCommandLine(argc, argv, &settings);
+
+	if(settings.uiTicks == 0)
+		settings.uiTicks = 1;
+
+	printf("Sync fan-out per tick (%.0fx%.0fm, radius %.0fm, %d ticks)\n", settings.fArea, settings.fArea, settings.fRadius, settings.uiTicks);
+	printf("players          grid     dimension   syncs\n");
+
+	unsigned int uiPlayerCounts[] = { 16, 32, 48, 64, 96, 128, 256, 512 };
+
+	for(unsigned int i = 0; i < (sizeof(uiPlayerCounts) / sizeof(unsigned int)); i++)
+	{
+		SyncBenchResult grid = RunBenchmark(&settings, uiPlayerCounts[i], BENCH_MODE_GRID);
+		SyncBenchResult dimension = RunBenchmark(&settings, uiPlayerCounts[i], BENCH_MODE_DIMENSION);
+		printf("%7d %10.1fus %10.1fus %7d\n", uiPlayerCounts[i], grid.dMicroseconds, dimension.dMicroseconds, grid.uiSyncs);
+	}
+
+	return 0;
+}
@@ -8,11 +8,13 @@
 //==============================================================================
 
 #include <map>
-#include <list>
+#include <vector>
+#include <algorithm>
 
 #include <Scripting/CSquirrelArguments.h>
 #include <Scripting/CSquirrel.h>
 #include <Scripting/CScriptingManager.h>
+#include <Scripting/CScriptProfiler.h>
 // FIXUPDATE
 // jenksta: this is kinda hacky :/
 #ifdef _SERVER
@@ -21,6 +23,7 @@
 #endif
 
 extern CScriptingManager * g_pScriptingManager;
+extern CScriptProfiler * g_pScriptProfiler;
 
 class CEventHandler
 {
@@ -39,12 +42,14 @@ public:
 class CSquirrelEventHandler : public CEventHandler
 {
 	SQVM * m_pVM;
+	CSquirrel * m_pScript;
 	SQObjectPtr m_pFunction;
 
 public:
 	CSquirrelEventHandler(SQVM * pVM, SQObjectPtr pFunction)
 	{
 		m_pVM = pVM;
+		m_pScript = g_pScriptingManager->Get(pVM);
 		m_pFunction = pFunction;
 	}
 
@@ -58,10 +63,10 @@ public:
 
 	void Call(CSquirrelArguments* pArguments, CSquirrelArgument* pReturn)
 	{
-		// Check if the VM does exist
-		CSquirrel* pScript = g_pScriptingManager->Get(m_pVM); 
-		if(pScript)
-			pScript->Call(m_pFunction, pArguments, pReturn);
+		// The handlers of a script are removed when it unloads (see CEvents::RemoveScript)
+		// so the script is always valid here and we don't have to look it up for every call
+		if(m_pScript)
+			m_pScript->Call(m_pFunction, pArguments, pReturn);
 	}
 };
 #ifdef _SERVER
@@ -88,107 +93,164 @@ public:
 	}
 };
 #endif
-class CEvents : public std::map< String, std::list< CEventHandler* > >
+// Event names are interned into ids so hot callers can look an event up once
+// and then call it without building a String or searching the name map
+typedef unsigned int EventId;
+
+typedef std::vector< CEventHandler* > EventHandlers;
+
+class CEvents
 #ifdef _SERVER
-	, public CEventsInterface
+	: public CEventsInterface
 #endif
 {
+private:
+	std::map< String, EventId > m_eventIds;
+	std::vector< EventHandlers > m_eventHandlers;
+	std::vector< String > m_eventNames;
+	unsigned int m_uiCallDepth;
+	bool m_bRemovedHandlers;
+
+	// Remove a handler by marking it as removed (NULL), the handlers are only compacted when no event
+	// is being called so a handler removing itself or others doesn't move the handlers of a running call
+	void RemoveHandler(EventHandlers& handlers, size_t i)
+	{
+		handlers[i] = NULL;
+		m_bRemovedHandlers = true;
+
+		if(m_uiCallDepth == 0)
+			CompactHandlers();
+	}
+
+	void CompactHandlers()
+	{
+		for(std::vector< EventHandlers >::iterator iter = m_eventHandlers.begin(); iter != m_eventHandlers.end(); ++ iter)
+			(*iter).erase(std::remove((*iter).begin(), (*iter).end(), (CEventHandler *)NULL), (*iter).end());
+
+		m_bRemovedHandlers = false;
+	}
+
+	// Get the handlers of an event without interning its name (NULL if it was never interned)
+	EventHandlers* GetHandlers(String strName)
+	{
+		std::map< String, EventId >::iterator iter = m_eventIds.find(strName);
+		if(iter != m_eventIds.end())
+			return &m_eventHandlers[(*iter).second];
+
+		return NULL;
+	}
+
 public:
+	CEvents()
+	{
+		m_uiCallDepth = 0;
+		m_bRemovedHandlers = false;
+	}
+
 	~CEvents()
 	{
-		clear();
+		Clear();
+	}
+
+	// Get the id of an event, the id stays the same for the lifetime of the events instance
+	EventId GetEventId(String strName)
+	{
+		std::map< String, EventId >::iterator iter = m_eventIds.find(strName);
+		if(iter != m_eventIds.end())
+			return (*iter).second;
+
+		// new - intern the event name
+		EventId eventId = (EventId)m_eventHandlers.size();
+		m_eventIds.insert(std::pair< String, EventId >(strName, eventId));
+		m_eventHandlers.push_back(EventHandlers());
+		m_eventNames.push_back(strName);
+		return eventId;
 	}
 
 	bool Add(String strName, CEventHandler* pEventHandler)
 	{
-		// Any events with that name?
-		CEvents::iterator iter = find(strName);
-		if(iter != end())
-		{
-			// Event exists, check if the function is registered already
-			for(std::list< CEventHandler* >::iterator iter2 = (*iter).second.begin(); iter2 != (*iter).second.end(); ++ iter2)
-			{
-				if(pEventHandler->equals(*iter2))
-					return false;
-			}
-		}
-		else
-		{
-			// new - create the event
-			std::pair< std::map< String, std::list< CEventHandler* > >::iterator, bool > ret;
-			ret = insert(std::pair< String, std::list< CEventHandler* > >( strName, std::list< CEventHandler* >( ) ) );
+		return Add(GetEventId(strName), pEventHandler);
+	}
 
-			iter = ret.first;
+	bool Add(EventId eventId, CEventHandler* pEventHandler)
+	{
+		EventHandlers& handlers = m_eventHandlers[eventId];
+
+		// Check if the function is registered already
+		for(EventHandlers::iterator iter = handlers.begin(); iter != handlers.end(); ++ iter)
+		{
+			if(*iter && pEventHandler->equals(*iter))
+				return false;
 		}
 
 		// insert the handler
-		(*iter).second.push_back(pEventHandler);
+		handlers.push_back(pEventHandler);
 		return true;
 	}
 
 	bool Remove(String strName, CEventHandler* pEventHandler)
 	{
 		// Any events with that name?
-		CEvents::iterator iter = find(strName);
-		if(iter != end())
+		EventHandlers* pHandlers = GetHandlers(strName);
+		if(pHandlers)
 		{
 			// Check if it exists, if so remove it
-			bool bRemoved = false;
-			for(std::list< CEventHandler* >::iterator iter2 = (*iter).second.begin(); iter2 != (*iter).second.end(); )
+			for(size_t i = 0; i < pHandlers->size(); ++ i)
 			{
-				if(pEventHandler->equals(*iter2))
+				if((*pHandlers)[i] && pEventHandler->equals((*pHandlers)[i]))
 				{
-					(*iter).second.erase(iter2++);
-					bRemoved = true;
-					break;
+					RemoveHandler(*pHandlers, i);
+					return true;
 				}
-				else
-					iter2 ++;
 			}
-
-			if(bRemoved)
-			{
-				// remove the event list if it is empty
-				if((*iter).second.size() == 0)
-				{
-					erase(iter);
-				}
-			}
-
-			return bRemoved;
 		}
 
-		// no such event - can't remove handlers
+		// no such event or handler - can't remove it
 		return false;
 	}
 
 	bool RemoveScript(SQVM * pVM)
 	{
-		for(CEvents::iterator iter = begin(); iter != end(); )
+		for(std::vector< EventHandlers >::iterator iter = m_eventHandlers.begin(); iter != m_eventHandlers.end(); ++ iter)
 		{
-			for(std::list< CEventHandler* >::iterator iter2 = (*iter).second.begin(); iter2 != (*iter).second.end(); )
+			for(EventHandlers::iterator iter2 = (*iter).begin(); iter2 != (*iter).end(); ++ iter2)
 			{
-				if((*iter2)->GetScript() == pVM)
-					(*iter).second.erase(iter2++);
-				else
-					iter2 ++;
+				if(*iter2 && (*iter2)->GetScript() == pVM)
+				{
+					*iter2 = NULL;
+					m_bRemovedHandlers = true;
+				}
 			}
-
-			// remove events with no handlers
-			if((*iter).second.size() == 0)
-				erase(iter++);
-			else
-				iter++;
 		}
 
+		if(m_uiCallDepth == 0 && m_bRemovedHandlers)
+			CompactHandlers();
+
 		return true;
 	}
 
+	void Clear()
+	{
+		// Remove all handlers but keep the event ids (callers may have cached them)
+		for(std::vector< EventHandlers >::iterator iter = m_eventHandlers.begin(); iter != m_eventHandlers.end(); ++ iter)
+			std::fill((*iter).begin(), (*iter).end(), (CEventHandler *)NULL);
+
+		m_bRemovedHandlers = true;
+
+		if(m_uiCallDepth == 0)
+			CompactHandlers();
+	}
+
 	bool IsEventRegistered(String eventName)
 	{		
 		// TODO: Add checking for special script also
-		CEvents::iterator iter = find(eventName);
-		return iter != end();
+		EventHandlers* pHandlers = GetHandlers(eventName);
+		return pHandlers && !pHandlers->empty();
+	}
+
+	bool IsEventRegistered(EventId eventId)
+	{
+		return !m_eventHandlers[eventId].empty();
 	}
 
 #ifdef _SERVER
@@ -212,7 +274,8 @@ public:
 	CSquirrelArgument Call(String strName, CSquirrel* pScript = NULL)
 	{
 		CSquirrelArgument pReturn(1);
-		Call(strName, &CSquirrelArguments(), &pReturn, pScript);
+		CSquirrelArguments pArguments;
+		Call(strName, &pArguments, &pReturn, pScript);
 		return pReturn;
 	}
 
@@ -225,21 +288,62 @@ public:
 
 	void Call(String strName, CSquirrelArguments* pArguments, CSquirrelArgument* pReturn, CSquirrel* pScript = NULL)
 	{
+		// Any events with that name?
+		std::map< String, EventId >::iterator iter = m_eventIds.find(strName);
+		if(iter != m_eventIds.end())
+			Call((*iter).second, pArguments, pReturn, pScript);
+	}
+
+	CSquirrelArgument Call(EventId eventId, CSquirrel* pScript = NULL)
+	{
+		CSquirrelArgument pReturn(1);
+		CSquirrelArguments pArguments;
+		Call(eventId, &pArguments, &pReturn, pScript);
+		return pReturn;
+	}
+
+	CSquirrelArgument Call(EventId eventId, CSquirrelArguments* pArguments, CSquirrel* pScript = NULL)
+	{
+		CSquirrelArgument pReturn(1);
+		Call(eventId, pArguments, &pReturn, pScript);
+		return pReturn;
+	}
+
+	void Call(EventId eventId, CSquirrelArguments* pArguments, CSquirrelArgument* pReturn, CSquirrel* pScript = NULL)
+	{
+		if(m_eventHandlers[eventId].empty())
+			return;
+
+		// attribute the time of the handlers to the event while the script profiler runs
+		bool bProfile = (g_pScriptProfiler && g_pScriptProfiler->IsActive());
+		if(bProfile)
+			g_pScriptProfiler->PushContext(String("event %s", m_eventNames[eventId].Get()));
+
 		SQVM* pVM = pScript ? pScript->GetVM() : 0;
+		m_uiCallDepth++;
 
-		// Any events with that name?
-		CEvents::iterator iter = find(strName);
-		if(iter != end())
+		// loop through all handlers (by index as a handler may add handlers, and look the handlers up
+		// again every time as adding a new event may move them, removed handlers stay until we are done)
+		for(size_t i = 0; i < m_eventHandlers[eventId].size(); ++ i)
 		{
-			// loop through all handlers
-			for(std::list< CEventHandler* >::iterator iter2 = (*iter).second.begin(); iter2 != (*iter).second.end(); ++ iter2)
-			{
-				// not for a specific script; or that script is the one we want
-				if(!pVM || pVM == (*iter2)->GetScript())
-				{
-					(*iter2)->Call(pArguments, pReturn);
-				}
-			}
+			CEventHandler* pEventHandler = m_eventHandlers[eventId][i];
+
+			// has the handler been removed?
+			if(!pEventHandler)
+				continue;
+
+			// not for a specific script; or that script is the one we want
+			if(!pVM || pVM == pEventHandler->GetScript())
+				pEventHandler->Call(pArguments, pReturn);
 		}
+
+		// compact the handlers once the outermost call is done
+		m_uiCallDepth--;
+
+		if(m_uiCallDepth == 0 && m_bRemovedHandlers)
+			CompactHandlers();
+
+		if(bProfile)
+			g_pScriptProfiler->PopContext();
 	}
 };
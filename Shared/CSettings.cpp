@@ -25,8 +25,14 @@ void CSettings::LoadDefaults()
 	AddInteger("port", 9999, 1024, 65535);
 	AddInteger("httpport", 9998, 80, 65535);
 	AddString("httpserver", "");
-	AddInteger("maxplayers", MAX_PLAYERS, 1, MAX_PLAYERS);
+	AddInteger("maxplayers", 48, 1, MAX_PLAYERS);
 	AddInteger("maxvehicles", MAX_VEHICLES, 0, MAX_VEHICLES);
+	AddInteger("tickrate", 200, 10, 1000);
+	AddFloat("syncradius", 500.0f, 0.0f, MAX_SYNC_RADIUS);
+	AddFloat("syncneardistance", 100.0f, 0.0f, 10000.0f);
+	AddFloat("syncmiddistance", 250.0f, 0.0f, 10000.0f);
+	AddInteger("syncmidinterval", 3, 1, 255);
+	AddInteger("syncfarinterval", 10, 1, 255);
 	AddString("password", "");
 	AddBool("query", true);
 	AddBool("listed", false);
@@ -42,6 +48,7 @@ void CSettings::LoadDefaults()
 	AddFloat("wind",0.0,0.0,50.0);
 	AddBool("silent", false);
 	AddBool("timestamp", true);
+	AddBool("scriptcache", true);
 	AddList("script");
 	AddList("clientscript");
 	AddList("clientresource");
@@ -43,10 +43,20 @@
 #endif
 
 // Network module version
-#define NETWORK_MODULE_VERSION 0x08
+#define NETWORK_MODULE_VERSION 0x0F
 
 // Network version - increment this when packet layouts change!
-#define NETWORK_VERSION 0x8A
+#define NETWORK_VERSION 0x90
+
+// Sync format version - increment this when the packed sync layouts change!
+#define SYNC_FORMAT_VERSION 3
+#define SYNC_FORMAT_VERSION_BITS 4
+
+// Bits used for the size of each sync in a batched sync
+#define SYNC_BATCH_ENTRY_SIZE_BITS 11
+
+// Max distance in which players receive each others sync
+#define MAX_SYNC_RADIUS 10000.0f
 
 // Tick Rate
 #define TICK_RATE 100
@@ -54,7 +64,8 @@
 // Defines used for the max amount of entities we (IV:MP, not GTA) can handle
 // jenksta: although they may be streamed, shouldn't they at least have some sensible limit?
 // NOTE: (if client-side entitys are introduced, those should not use ids from the same range as server ids)
-#define MAX_PLAYERS 48/*128*/ // Player Info Array Size: 64 // Ped Pool Size: 64
+// NOTE: MAX_PLAYERS is the size of the player id range, the server decides how many of them are used with the maxplayers setting
+#define MAX_PLAYERS 512 // Player Info Array Size: 64 // Ped Pool Size: 64 (clients only create the players they have a free player info for)
 #define MAX_VEHICLES 0xFFFE // Streamed. See note on Pickups. Vehicle Pool Size: 140
 #define MAX_OBJECTS 0xFFFE // Streamed. See note on Pickups. Object Pool Size: 1300
 #define MAX_CHECKPOINTS 0xFFFE // Streamed. Checkpoint Pool Size: See CStreamer.h
@@ -218,23 +229,45 @@ struct InVehicleSyncData
 	CVector3 vecPos;                       // vehicle position
 	CVector3 vecRotation;                  // vehicle rotation
 	unsigned int uiHealth	  ;            // vehicle health
-	unsigned char byteColors[4];           // vehicle colors
 	CVector3 vecTurnSpeed;                 // vehicle turn speed
 	CVector3 vecMoveSpeed;                 // vehicle move speed
-	bool bEngineStatus : 1;				   // vehicle engine status
-	bool hHazardLights : 1;				   // hazardlights status
 	float fPetrolHealth;				   // vehicle petrol tank health
+	float fQuaternion[4];					// vehicle quaternion
+	unsigned int uPlayerHealthArmour : 32; // player health and armour (first 16bit Health last 16bit Armour)
+	unsigned int uPlayerWeaponInfo;        // player weapon and ammo
+};
+
+// Vehicle state flags (only the states that changed are sent)
+enum eVehicleStateFlags
+{
+	VEHICLE_STATE_COLORS = (1 << 0),
+	VEHICLE_STATE_DIRT_LEVEL = (1 << 1),
+	VEHICLE_STATE_DOORS = (1 << 2),
+	VEHICLE_STATE_ENGINE = (1 << 3),
+	VEHICLE_STATE_LIGHTS = (1 << 4),
+	VEHICLE_STATE_TAXI_LIGHTS = (1 << 5),
+	VEHICLE_STATE_SIREN = (1 << 6),
+	VEHICLE_STATE_GPS = (1 << 7),
+	VEHICLE_STATE_WINDOWS = (1 << 8),
+	VEHICLE_STATE_TYRES = (1 << 9),
+	VEHICLE_STATE_ALL = ((1 << 10) - 1)
+};
+
+#define VEHICLE_STATE_FLAG_BITS 10
+
+struct VehicleStateData
+{
+	unsigned short usFlags;                // states set in this packet (eVehicleStateFlags)
+	unsigned char byteColors[4];           // vehicle colors
 	float fDirtLevel;					   // vehicle dirt
 	float fDoor[6];						   // vehicle doors(open angle)
+	bool bEngineStatus;					   // vehicle engine status
 	bool bLights;						   // vehicle lights
-	bool bTaxiLights : 1;				   // vehicle taxilight
-	bool bSirenState : 1;				   // vehicle siren state
+	bool bTaxiLights;					   // vehicle taxilight
+	bool bSirenState;					   // vehicle siren state
+	bool bGpsState;				           // gps state
 	bool bWindow[4];					   // vehicle window
 	bool bTyre[6];						   // vehicle tyres
-	bool bGpsState : 1;				       // gps state
-	float fQuaternion[4];					// vehicle quaternion
-	unsigned int uPlayerHealthArmour : 32; // player health and armour (first 16bit Health last 16bit Armour)
-	unsigned int uPlayerWeaponInfo;        // player weapon and ammo
 };
 
 struct PassengerSyncData
@@ -61,6 +61,53 @@ static CVector3 ConvertDegreesToRadians(const CVector3 &vecRotation)
 					ConvertDegreesToRadians(vecRotation.fZ));
 }
 
+// Converts XYZ euler angles (in degrees) to a quaternion (x, y, z, w)
+static void ConvertEulerAnglesToQuaternion(const CVector3 &vecRotation, float * fQuaternion)
+{
+	// Get the sine and cosine of each half angle
+	float fHalfX = (vecRotation.fX * RADS_PER_DEG * 0.5f);
+	float fHalfY = (vecRotation.fY * RADS_PER_DEG * 0.5f);
+	float fHalfZ = (vecRotation.fZ * RADS_PER_DEG * 0.5f);
+	float fSinX = sin(fHalfX), fCosX = cos(fHalfX);
+	float fSinY = sin(fHalfY), fCosY = cos(fHalfY);
+	float fSinZ = sin(fHalfZ), fCosZ = cos(fHalfZ);
+
+	// X * Y * Z
+	fQuaternion[0] = ((fSinX * fCosY * fCosZ) + (fCosX * fSinY * fSinZ));
+	fQuaternion[1] = ((fCosX * fSinY * fCosZ) - (fSinX * fCosY * fSinZ));
+	fQuaternion[2] = ((fCosX * fCosY * fSinZ) + (fSinX * fSinY * fCosZ));
+	fQuaternion[3] = ((fCosX * fCosY * fCosZ) - (fSinX * fSinY * fSinZ));
+}
+
+// Converts a quaternion (x, y, z, w) to XYZ euler angles (in degrees)
+// From http://www.geometrictools.com/LibFoundation/Mathematics/Wm4Matrix3.inl.html
+static void ConvertQuaternionToEulerAngles(const float * fQuaternion, CVector3 &vecRotation)
+{
+	float x = fQuaternion[0], y = fQuaternion[1], z = fQuaternion[2], w = fQuaternion[3];
+
+	// Get the rotation matrix entries we need
+	float r00 = (1.0f - 2.0f * (y * y + z * z));
+	float r01 = (2.0f * (x * y - w * z));
+	float r02 = (2.0f * (x * z + w * y));
+	float r10 = (2.0f * (x * y + w * z));
+	float r11 = (1.0f - 2.0f * (x * x + z * z));
+	float r12 = (2.0f * (y * z - w * x));
+	float r22 = (1.0f - 2.0f * (x * x + y * y));
+	CVector3 vecRadians;
+
+	if(r02 < 1.0f)
+	{
+		if(r02 > -1.0f)
+			vecRadians = CVector3(atan2(-r12, r22), asin(r02), atan2(-r01, r00));
+		else
+			vecRadians = CVector3(-atan2(r10, r11), -HALF_PI, 0.0f);
+	}
+	else
+		vecRadians = CVector3(atan2(r10, r11), HALF_PI, 0.0f);
+
+	vecRotation = ConvertRadiansToDegrees(vecRadians);
+}
+
 // From Multi Theft Auto
 static float GetOffsetDegrees(float a, float b)
 {
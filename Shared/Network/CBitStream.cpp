@@ -9,7 +9,349 @@
 //==============================================================================
 
 #include "CBitStream.h"
+#include "../Common.h"
 #include <assert.h>
+#include <math.h>
+
+// Quantized position range and precision (1/64th of a unit)
+#define SYNC_POSITION_XY_RANGE 4096.0f
+#define SYNC_POSITION_XY_BITS 19
+#define SYNC_POSITION_Z_MIN -1024.0f
+#define SYNC_POSITION_Z_MAX 3072.0f
+#define SYNC_POSITION_Z_BITS 18
+
+// Quantized heading precision
+#define SYNC_HEADING_BITS 12
+
+// Quantized speed ranges and precision
+#define SYNC_MOVE_SPEED_RANGE 128.0f
+#define SYNC_MOVE_SPEED_BITS 14
+#define SYNC_TURN_SPEED_RANGE 16.0f
+#define SYNC_TURN_SPEED_BITS 11
+
+// Quaternions are sent as their three smallest components
+#define SYNC_QUATERNION_BITS 10
+
+// Quantized vehicle state ranges and precision
+#define SYNC_VEHICLE_HEALTH_BITS 10
+#define SYNC_PETROL_HEALTH_MIN -1000.0f
+#define SYNC_PETROL_HEALTH_MAX 1000.0f
+#define SYNC_PETROL_HEALTH_BITS 11
+#define SYNC_DIRT_LEVEL_MAX 15.0f
+#define SYNC_DIRT_LEVEL_BITS 8
+#define SYNC_DOOR_ANGLE_MAX 360.0f
+#define SYNC_DOOR_ANGLE_BITS 8
+
+// Aim vectors are sent as a direction and distance from the shot source
+#define SYNC_AIM_DIRECTION_BITS 11
+#define SYNC_AIM_DISTANCE_RANGE 1024.0f
+#define SYNC_AIM_DISTANCE_BITS 16
+
+// Bits used for health, armour, weapon and ammo when they are in their usual range
+#define SYNC_HEALTH_BITS 10
+#define SYNC_ARMOUR_BITS 8
+#define SYNC_WEAPON_BITS 6
+#define SYNC_AMMO_BITS 10
+
+// Write a value in uiSmallBits bits if it fits, otherwise write it in uiFullBits bits
+static void WriteRanged(CBitStream * pBitStream, unsigned int uiValue, unsigned int uiSmallBits, unsigned int uiFullBits)
+{
+	if(uiValue < (1u << uiSmallBits))
+	{
+		pBitStream->Write0();
+		pBitStream->WriteUInt(uiValue, uiSmallBits);
+	}
+	else
+	{
+		pBitStream->Write1();
+		pBitStream->WriteUInt(uiValue, uiFullBits);
+	}
+}
+
+static bool ReadRanged(CBitStream * pBitStream, unsigned int &uiValue, unsigned int uiSmallBits, unsigned int uiFullBits)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(pBitStream->ReadBit())
+		return pBitStream->ReadUInt(uiValue, uiFullBits);
+
+	return pBitStream->ReadUInt(uiValue, uiSmallBits);
+}
+
+// Write a control state, only writing the on foot or in vehicle part if it is used
+static void WriteControlState(CBitStream * pBitStream, const CControlState &controlState)
+{
+	bool bHasOnFootControls = false;
+	bool bHasVehicleControls = false;
+
+	for(int i = 0; i < 4; i++)
+	{
+		if(controlState.ucOnFootMove[i] != 0)
+			bHasOnFootControls = true;
+
+		if(controlState.ucInVehicleMove[i] != 0 || (i < 2 && controlState.ucInVehicleTriggers[i] != 0))
+			bHasVehicleControls = true;
+	}
+
+	pBitStream->WriteBit(bHasOnFootControls);
+
+	if(bHasOnFootControls)
+		pBitStream->Write((char *)controlState.ucOnFootMove, sizeof(controlState.ucOnFootMove));
+
+	pBitStream->WriteBit(bHasVehicleControls);
+
+	if(bHasVehicleControls)
+	{
+		pBitStream->Write((char *)controlState.ucInVehicleMove, sizeof(controlState.ucInVehicleMove));
+		pBitStream->Write((char *)controlState.ucInVehicleTriggers, sizeof(controlState.ucInVehicleTriggers));
+	}
+
+	pBitStream->WriteBits((unsigned char *)&controlState.keys, CControlState::KEY_COUNT);
+}
+
+static bool ReadControlState(CBitStream * pBitStream, CControlState &controlState)
+{
+	memset(&controlState, 0, sizeof(CControlState));
+
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(pBitStream->ReadBit() && !pBitStream->Read((char *)controlState.ucOnFootMove, sizeof(controlState.ucOnFootMove)))
+		return false;
+
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(pBitStream->ReadBit())
+	{
+		if(!pBitStream->Read((char *)controlState.ucInVehicleMove, sizeof(controlState.ucInVehicleMove)))
+			return false;
+
+		if(!pBitStream->Read((char *)controlState.ucInVehicleTriggers, sizeof(controlState.ucInVehicleTriggers)))
+			return false;
+	}
+
+	return pBitStream->ReadBits((unsigned char *)&controlState.keys, CControlState::KEY_COUNT);
+}
+
+// Write the player health (high 16 bits) and armour (low 16 bits)
+static void WriteHealthArmour(CBitStream * pBitStream, unsigned int uiHealthArmour)
+{
+	WriteRanged(pBitStream, (uiHealthArmour >> 16), SYNC_HEALTH_BITS, 16);
+	WriteRanged(pBitStream, (uiHealthArmour & 0xFFFF), SYNC_ARMOUR_BITS, 16);
+}
+
+static bool ReadHealthArmour(CBitStream * pBitStream, unsigned int &uiHealthArmour)
+{
+	unsigned int uiHealth, uiArmour;
+
+	if(!ReadRanged(pBitStream, uiHealth, SYNC_HEALTH_BITS, 16) || !ReadRanged(pBitStream, uiArmour, SYNC_ARMOUR_BITS, 16))
+		return false;
+
+	uiHealthArmour = ((uiHealth << 16) | uiArmour);
+	return true;
+}
+
+// Write the player weapon (high 12 bits) and ammo (low 20 bits)
+static void WriteWeaponInfo(CBitStream * pBitStream, unsigned int uiWeaponInfo)
+{
+	WriteRanged(pBitStream, (uiWeaponInfo >> 20), SYNC_WEAPON_BITS, 12);
+	WriteRanged(pBitStream, (uiWeaponInfo & 0xFFFFF), SYNC_AMMO_BITS, 20);
+}
+
+static bool ReadWeaponInfo(CBitStream * pBitStream, unsigned int &uiWeaponInfo)
+{
+	unsigned int uiWeapon, uiAmmo;
+
+	if(!ReadRanged(pBitStream, uiWeapon, SYNC_WEAPON_BITS, 12) || !ReadRanged(pBitStream, uiAmmo, SYNC_AMMO_BITS, 20))
+		return false;
+
+	uiWeaponInfo = ((uiWeapon << 20) | uiAmmo);
+	return true;
+}
+
+// Write a float quantized to [fMin, fMax] if it is in range, otherwise write it as a full float
+static void WriteRangedFloat(CBitStream * pBitStream, float fValue, float fMin, float fMax, unsigned int uiBits)
+{
+	if(fValue >= fMin && fValue <= fMax)
+	{
+		pBitStream->Write1();
+		pBitStream->WriteQuantized(fValue, fMin, fMax, uiBits);
+	}
+	else
+	{
+		pBitStream->Write0();
+		pBitStream->Write(fValue);
+	}
+}
+
+static bool ReadRangedFloat(CBitStream * pBitStream, float &fValue, float fMin, float fMax, unsigned int uiBits)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(pBitStream->ReadBit())
+		return pBitStream->ReadQuantized(fValue, fMin, fMax, uiBits);
+
+	return pBitStream->Read(fValue);
+}
+
+// Get the value a float has after being written with WriteRangedFloat and read back
+static float QuantizeRangedFloat(float fValue, float fMin, float fMax, unsigned int uiBits)
+{
+	// Values outside of the range are sent as they are
+	if(fValue < fMin || fValue > fMax)
+		return fValue;
+
+	unsigned int uiMaxValue = ((1u << uiBits) - 1);
+	unsigned int uiValue = (unsigned int)((((double)fValue - fMin) / ((double)fMax - fMin)) * uiMaxValue + 0.5);
+	return (float)(fMin + (((double)uiValue / uiMaxValue) * ((double)fMax - fMin)));
+}
+
+// Write an array of bools as one bit each
+static void WriteBoolArray(CBitStream * pBitStream, const bool * bValues, unsigned int uiCount)
+{
+	for(unsigned int i = 0; i < uiCount; i++)
+		pBitStream->WriteBit(bValues[i]);
+}
+
+static bool ReadBoolArray(CBitStream * pBitStream, bool * bValues, unsigned int uiCount)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < uiCount)
+		return false;
+
+	for(unsigned int i = 0; i < uiCount; i++)
+		bValues[i] = pBitStream->ReadBit();
+
+	return true;
+}
+
+// Write a world position, falling back to full floats if it is outside of the quantized range
+static void WritePosition(CBitStream * pBitStream, const CVector3 &vecPos)
+{
+	if(fabs(vecPos.fX) < SYNC_POSITION_XY_RANGE && fabs(vecPos.fY) < SYNC_POSITION_XY_RANGE && 
+		vecPos.fZ > SYNC_POSITION_Z_MIN && vecPos.fZ < SYNC_POSITION_Z_MAX)
+	{
+		pBitStream->Write1();
+		pBitStream->WriteQuantized(vecPos.fX, -SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_BITS);
+		pBitStream->WriteQuantized(vecPos.fY, -SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_BITS);
+		pBitStream->WriteQuantized(vecPos.fZ, SYNC_POSITION_Z_MIN, SYNC_POSITION_Z_MAX, SYNC_POSITION_Z_BITS);
+	}
+	else
+	{
+		pBitStream->Write0();
+		pBitStream->Write(vecPos);
+	}
+}
+
+static bool ReadPosition(CBitStream * pBitStream, CVector3 &vecPos)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(!pBitStream->ReadBit())
+		return pBitStream->Read(vecPos);
+
+	return (pBitStream->ReadQuantized(vecPos.fX, -SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_BITS) && 
+		pBitStream->ReadQuantized(vecPos.fY, -SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_RANGE, SYNC_POSITION_XY_BITS) && 
+		pBitStream->ReadQuantized(vecPos.fZ, SYNC_POSITION_Z_MIN, SYNC_POSITION_Z_MAX, SYNC_POSITION_Z_BITS));
+}
+
+// Write a velocity with each axis quantized to [-fRange, fRange] (a single bit if it is zero)
+static void WriteVelocity(CBitStream * pBitStream, const CVector3 &vecVelocity, float fRange, unsigned int uiBits)
+{
+	if(vecVelocity.IsEmpty())
+	{
+		pBitStream->Write0();
+		return;
+	}
+
+	pBitStream->Write1();
+	pBitStream->WriteQuantized(vecVelocity.fX, -fRange, fRange, uiBits);
+	pBitStream->WriteQuantized(vecVelocity.fY, -fRange, fRange, uiBits);
+	pBitStream->WriteQuantized(vecVelocity.fZ, -fRange, fRange, uiBits);
+}
+
+static bool ReadVelocity(CBitStream * pBitStream, CVector3 &vecVelocity, float fRange, unsigned int uiBits)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(!pBitStream->ReadBit())
+	{
+		vecVelocity = CVector3();
+		return true;
+	}
+
+	return (pBitStream->ReadQuantized(vecVelocity.fX, -fRange, fRange, uiBits) && 
+		pBitStream->ReadQuantized(vecVelocity.fY, -fRange, fRange, uiBits) && 
+		pBitStream->ReadQuantized(vecVelocity.fZ, -fRange, fRange, uiBits));
+}
+
+// Write an aim vector as a direction and distance from the shot source
+static void WriteAimVector(CBitStream * pBitStream, const CVector3 &vecSource, const CVector3 &vecTarget)
+{
+	CVector3 vecDirection = (vecTarget - vecSource);
+	float fDistance = vecDirection.Length();
+
+	if(fDistance > 0.0f && fDistance < SYNC_AIM_DISTANCE_RANGE)
+	{
+		pBitStream->Write1();
+		pBitStream->WriteNormVector((vecDirection / fDistance), SYNC_AIM_DIRECTION_BITS);
+		pBitStream->WriteQuantized(fDistance, 0.0f, SYNC_AIM_DISTANCE_RANGE, SYNC_AIM_DISTANCE_BITS);
+	}
+	else
+	{
+		pBitStream->Write0();
+		pBitStream->Write(vecTarget);
+	}
+}
+
+static bool ReadAimVector(CBitStream * pBitStream, const CVector3 &vecSource, CVector3 &vecTarget)
+{
+	if(pBitStream->GetNumberOfUnreadBits() < 1)
+		return false;
+
+	if(!pBitStream->ReadBit())
+		return pBitStream->Read(vecTarget);
+
+	CVector3 vecDirection;
+	float fDistance;
+
+	if(!pBitStream->ReadNormVector(vecDirection, SYNC_AIM_DIRECTION_BITS) || 
+		!pBitStream->ReadQuantized(fDistance, 0.0f, SYNC_AIM_DISTANCE_RANGE, SYNC_AIM_DISTANCE_BITS))
+		return false;
+
+	vecTarget = (vecSource + (vecDirection * fDistance));
+	return true;
+}
+
+// Write a short (max 255 characters) string
+static void WriteShortString(CBitStream * pBitStream, const char * szString)
+{
+	size_t sLength = strlen(szString);
+
+	if(sLength > 255)
+		sLength = 255;
+
+	pBitStream->Write((unsigned char)sLength);
+	pBitStream->Write(szString, sLength);
+}
+
+static bool ReadShortString(CBitStream * pBitStream, char * szString)
+{
+	unsigned char ucLength;
+
+	if(!pBitStream->Read(ucLength))
+		return false;
+
+	if(ucLength > 0 && !pBitStream->Read(szString, ucLength))
+		return false;
+
+	szString[ucLength] = '\0';
+	return true;
+}
 
 CBitStream::CBitStream()
 	: m_pData(m_stackData),
@@ -169,6 +511,329 @@ bool CBitStream::Read(CControlState &out)
 	return out.Deserialize(this);
 }
 
+void CBitStream::Write(const OnFootSyncData &in)
+{
+	// Write the sync format version
+	WriteUInt(SYNC_FORMAT_VERSION, SYNC_FORMAT_VERSION_BITS);
+
+	// Write the control state
+	WriteControlState(this, in.controlState);
+
+	// Write the position
+	WritePosition(this, in.vecPos);
+
+	// Write the heading (wrapped to [-PI, PI])
+	WriteQuantized((Math::WrapAround((in.fHeading + PI), DOUBLE_PI) - PI), -PI, PI, SYNC_HEADING_BITS);
+
+	// Write the move and turn speed
+	WriteVelocity(this, in.vecMoveSpeed, SYNC_MOVE_SPEED_RANGE, SYNC_MOVE_SPEED_BITS);
+	WriteVelocity(this, in.vecTurnSpeed, SYNC_TURN_SPEED_RANGE, SYNC_TURN_SPEED_BITS);
+
+	// Write the ducking state
+	WriteBit(in.bDuckState);
+
+	// Write the health and armour
+	WriteHealthArmour(this, in.uHealthArmour);
+
+	// Write the weapon and ammo
+	WriteWeaponInfo(this, in.uWeaponInfo);
+
+	// Write the animation (only if there is one)
+	WriteBit(in.bAnim);
+
+	if(in.bAnim)
+	{
+		WriteShortString(this, in.szAnimGroup);
+		WriteShortString(this, in.szAnimSpecific);
+		Write(in.fAnimTime);
+	}
+}
+
+void CBitStream::Write(const InVehicleSyncData &in)
+{
+	// Write the sync format version
+	WriteUInt(SYNC_FORMAT_VERSION, SYNC_FORMAT_VERSION_BITS);
+
+	// Write the control state
+	WriteControlState(this, in.controlState);
+
+	// Write the position
+	WritePosition(this, in.vecPos);
+
+	// Write the rotation as a quaternion
+	float fQuaternion[4];
+	Math::ConvertEulerAnglesToQuaternion(in.vecRotation, fQuaternion);
+	WriteQuaternion(fQuaternion, SYNC_QUATERNION_BITS);
+
+	// Write the move and turn speed
+	WriteVelocity(this, in.vecMoveSpeed, SYNC_MOVE_SPEED_RANGE, SYNC_MOVE_SPEED_BITS);
+	WriteVelocity(this, in.vecTurnSpeed, SYNC_TURN_SPEED_RANGE, SYNC_TURN_SPEED_BITS);
+
+	// Write the health and petrol tank health
+	WriteRanged(this, in.uiHealth, SYNC_VEHICLE_HEALTH_BITS, 32);
+	WriteRangedFloat(this, in.fPetrolHealth, SYNC_PETROL_HEALTH_MIN, SYNC_PETROL_HEALTH_MAX, SYNC_PETROL_HEALTH_BITS);
+
+	// Write the player health and armour
+	WriteHealthArmour(this, in.uPlayerHealthArmour);
+
+	// Write the player weapon and ammo
+	WriteWeaponInfo(this, in.uPlayerWeaponInfo);
+}
+
+bool CBitStream::Read(InVehicleSyncData &out)
+{
+	// Read and check the sync format version
+	unsigned int uiVersion;
+
+	if(!ReadUInt(uiVersion, SYNC_FORMAT_VERSION_BITS) || uiVersion != SYNC_FORMAT_VERSION)
+		return false;
+
+	// Read the control state
+	if(!ReadControlState(this, out.controlState))
+		return false;
+
+	// Read the position
+	if(!ReadPosition(this, out.vecPos))
+		return false;
+
+	// Read the rotation
+	if(!ReadQuaternion(out.fQuaternion, SYNC_QUATERNION_BITS))
+		return false;
+
+	Math::ConvertQuaternionToEulerAngles(out.fQuaternion, out.vecRotation);
+
+	// Read the move and turn speed
+	if(!ReadVelocity(this, out.vecMoveSpeed, SYNC_MOVE_SPEED_RANGE, SYNC_MOVE_SPEED_BITS))
+		return false;
+
+	if(!ReadVelocity(this, out.vecTurnSpeed, SYNC_TURN_SPEED_RANGE, SYNC_TURN_SPEED_BITS))
+		return false;
+
+	// Read the health and petrol tank health
+	if(!ReadRanged(this, out.uiHealth, SYNC_VEHICLE_HEALTH_BITS, 32))
+		return false;
+
+	if(!ReadRangedFloat(this, out.fPetrolHealth, SYNC_PETROL_HEALTH_MIN, SYNC_PETROL_HEALTH_MAX, SYNC_PETROL_HEALTH_BITS))
+		return false;
+
+	// Read the player health and armour
+	unsigned int uiHealthArmour;
+
+	if(!ReadHealthArmour(this, uiHealthArmour))
+		return false;
+
+	out.uPlayerHealthArmour = uiHealthArmour;
+
+	// Read the player weapon and ammo
+	return ReadWeaponInfo(this, out.uPlayerWeaponInfo);
+}
+
+void CBitStream::Write(const VehicleStateData &in)
+{
+	// Write which states are set
+	WriteUInt(in.usFlags, VEHICLE_STATE_FLAG_BITS);
+
+	// Write the states that are set
+	if(in.usFlags & VEHICLE_STATE_COLORS)
+		Write((char *)in.byteColors, sizeof(in.byteColors));
+
+	if(in.usFlags & VEHICLE_STATE_DIRT_LEVEL)
+		WriteRangedFloat(this, in.fDirtLevel, 0.0f, SYNC_DIRT_LEVEL_MAX, SYNC_DIRT_LEVEL_BITS);
+
+	if(in.usFlags & VEHICLE_STATE_DOORS)
+	{
+		// A single bit for closed doors
+		for(int i = 0; i < 6; i++)
+		{
+			WriteBit(in.fDoor[i] != 0.0f);
+
+			if(in.fDoor[i] != 0.0f)
+				WriteRangedFloat(this, in.fDoor[i], 0.0f, SYNC_DOOR_ANGLE_MAX, SYNC_DOOR_ANGLE_BITS);
+		}
+	}
+
+	if(in.usFlags & VEHICLE_STATE_ENGINE)
+		WriteBit(in.bEngineStatus);
+
+	if(in.usFlags & VEHICLE_STATE_LIGHTS)
+		WriteBit(in.bLights);
+
+	if(in.usFlags & VEHICLE_STATE_TAXI_LIGHTS)
+		WriteBit(in.bTaxiLights);
+
+	if(in.usFlags & VEHICLE_STATE_SIREN)
+		WriteBit(in.bSirenState);
+
+	if(in.usFlags & VEHICLE_STATE_GPS)
+		WriteBit(in.bGpsState);
+
+	if(in.usFlags & VEHICLE_STATE_WINDOWS)
+		WriteBoolArray(this, in.bWindow, 4);
+
+	if(in.usFlags & VEHICLE_STATE_TYRES)
+		WriteBoolArray(this, in.bTyre, 6);
+}
+
+void CBitStream::QuantizeVehicleState(VehicleStateData &data)
+{
+	data.fDirtLevel = QuantizeRangedFloat(data.fDirtLevel, 0.0f, SYNC_DIRT_LEVEL_MAX, SYNC_DIRT_LEVEL_BITS);
+
+	for(int i = 0; i < 6; i++)
+	{
+		if(data.fDoor[i] != 0.0f)
+			data.fDoor[i] = QuantizeRangedFloat(data.fDoor[i], 0.0f, SYNC_DOOR_ANGLE_MAX, SYNC_DOOR_ANGLE_BITS);
+		else
+			data.fDoor[i] = 0.0f;
+	}
+}
+
+bool CBitStream::Read(VehicleStateData &out)
+{
+	// Read which states are set
+	unsigned int uiFlags;
+
+	if(!ReadUInt(uiFlags, VEHICLE_STATE_FLAG_BITS))
+		return false;
+
+	out.usFlags = (unsigned short)uiFlags;
+
+	// Read the states that are set
+	if((out.usFlags & VEHICLE_STATE_COLORS) && !Read((char *)out.byteColors, sizeof(out.byteColors)))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_DIRT_LEVEL) && !ReadRangedFloat(this, out.fDirtLevel, 0.0f, SYNC_DIRT_LEVEL_MAX, SYNC_DIRT_LEVEL_BITS))
+		return false;
+
+	if(out.usFlags & VEHICLE_STATE_DOORS)
+	{
+		for(int i = 0; i < 6; i++)
+		{
+			if(GetNumberOfUnreadBits() < 1)
+				return false;
+
+			out.fDoor[i] = 0.0f;
+
+			if(ReadBit() && !ReadRangedFloat(this, out.fDoor[i], 0.0f, SYNC_DOOR_ANGLE_MAX, SYNC_DOOR_ANGLE_BITS))
+				return false;
+		}
+	}
+
+	if((out.usFlags & VEHICLE_STATE_ENGINE) && !ReadBoolArray(this, &out.bEngineStatus, 1))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_LIGHTS) && !ReadBoolArray(this, &out.bLights, 1))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_TAXI_LIGHTS) && !ReadBoolArray(this, &out.bTaxiLights, 1))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_SIREN) && !ReadBoolArray(this, &out.bSirenState, 1))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_GPS) && !ReadBoolArray(this, &out.bGpsState, 1))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_WINDOWS) && !ReadBoolArray(this, out.bWindow, 4))
+		return false;
+
+	if((out.usFlags & VEHICLE_STATE_TYRES) && !ReadBoolArray(this, out.bTyre, 6))
+		return false;
+
+	return true;
+}
+
+void CBitStream::Write(const AimSyncData &in)
+{
+	// Write the shot source
+	WritePosition(this, in.vecShotSource);
+
+	// Write the other vectors relative to the shot source
+	WriteAimVector(this, in.vecShotSource, in.vecAimTarget);
+	WriteAimVector(this, in.vecShotSource, in.vecShotTarget);
+	WriteAimVector(this, in.vecShotSource, in.vecLookAt);
+}
+
+bool CBitStream::Read(OnFootSyncData &out)
+{
+	// Read and check the sync format version
+	unsigned int uiVersion;
+
+	if(!ReadUInt(uiVersion, SYNC_FORMAT_VERSION_BITS) || uiVersion != SYNC_FORMAT_VERSION)
+		return false;
+
+	// Read the control state
+	if(!ReadControlState(this, out.controlState))
+		return false;
+
+	// Read the position
+	if(!ReadPosition(this, out.vecPos))
+		return false;
+
+	// Read the heading
+	if(!ReadQuantized(out.fHeading, -PI, PI, SYNC_HEADING_BITS))
+		return false;
+
+	// Read the move and turn speed
+	if(!ReadVelocity(this, out.vecMoveSpeed, SYNC_MOVE_SPEED_RANGE, SYNC_MOVE_SPEED_BITS))
+		return false;
+
+	if(!ReadVelocity(this, out.vecTurnSpeed, SYNC_TURN_SPEED_RANGE, SYNC_TURN_SPEED_BITS))
+		return false;
+
+	// Read the ducking state
+	if(GetNumberOfUnreadBits() < 1)
+		return false;
+
+	out.bDuckState = ReadBit();
+
+	// Read the health and armour
+	unsigned int uiHealthArmour;
+
+	if(!ReadHealthArmour(this, uiHealthArmour))
+		return false;
+
+	out.uHealthArmour = uiHealthArmour;
+
+	// Read the weapon and ammo
+	if(!ReadWeaponInfo(this, out.uWeaponInfo))
+		return false;
+
+	// Read the animation
+	if(GetNumberOfUnreadBits() < 1)
+		return false;
+
+	out.bAnim = ReadBit();
+
+	if(out.bAnim)
+	{
+		if(!ReadShortString(this, out.szAnimGroup) || !ReadShortString(this, out.szAnimSpecific))
+			return false;
+
+		if(!Read(out.fAnimTime))
+			return false;
+	}
+	else
+	{
+		out.szAnimGroup[0] = '\0';
+		out.szAnimSpecific[0] = '\0';
+		out.fAnimTime = 0.0f;
+	}
+
+	return true;
+}
+
+bool CBitStream::Read(AimSyncData &out)
+{
+	// Read the shot source
+	if(!ReadPosition(this, out.vecShotSource))
+		return false;
+
+	// Read the other vectors relative to the shot source
+	return (ReadAimVector(this, out.vecShotSource, out.vecAimTarget) && 
+		ReadAimVector(this, out.vecShotSource, out.vecShotTarget) && 
+		ReadAimVector(this, out.vecShotSource, out.vecLookAt));
+}
+
 void CBitStream::Write(const char * pIn, const unsigned int uiSizeInBytes)
 {
 	// Is the size we need to write 0?
@@ -448,6 +1113,187 @@ bool CBitStream::ReadBits(unsigned char * pOut, unsigned int uiSizeInBits, bool
 	return true;
 }
 
+void CBitStream::Write(const CBitStream * pBitStream)
+{
+	unsigned int uiSizeInBits = pBitStream->GetNumberOfBitsUsed();
+
+	// Write the whole bytes
+	WriteBits(pBitStream->GetData(), (uiSizeInBits & ~7), false);
+
+	// Write the last partial byte (if any) with the unused bits cleared
+	if(uiSizeInBits & 7)
+	{
+		unsigned char ucData = (pBitStream->GetData()[uiSizeInBits >> 3] & (0xFF << (8 - (uiSizeInBits & 7))));
+		WriteBits(&ucData, (uiSizeInBits & 7), false);
+	}
+}
+
+bool CBitStream::Read(CBitStream * pBitStream, unsigned int uiSizeInBits)
+{
+	// Do we have enough bits to read?
+	if(GetNumberOfUnreadBits() < uiSizeInBits)
+		return false;
+
+	// Copy the bits a byte at a time
+	unsigned char ucData;
+
+	while(uiSizeInBits > 0)
+	{
+		unsigned int uiBits = ((uiSizeInBits < 8) ? uiSizeInBits : 8);
+		ReadBits(&ucData, uiBits, false);
+
+		// Clear the bits we read past the end
+		ucData &= (0xFF << (8 - uiBits));
+		pBitStream->WriteBits(&ucData, uiBits, false);
+		uiSizeInBits -= uiBits;
+	}
+
+	return true;
+}
+
+void CBitStream::WriteUInt(unsigned int uiIn, unsigned int uiSizeInBits)
+{
+	// NOTE: This relies on the integer being stored little endian (same as RakNet)
+	WriteBits((unsigned char *)&uiIn, uiSizeInBits, true);
+}
+
+bool CBitStream::ReadUInt(unsigned int &uiOut, unsigned int uiSizeInBits)
+{
+	uiOut = 0;
+	return ReadBits((unsigned char *)&uiOut, uiSizeInBits, true);
+}
+
+void CBitStream::WriteQuantized(float fIn, float fMin, float fMax, unsigned int uiSizeInBits)
+{
+	unsigned int uiMaxValue = ((1u << uiSizeInBits) - 1);
+
+	// Clamp the value to the range
+	if(fIn < fMin)
+		fIn = fMin;
+	else if(fIn > fMax)
+		fIn = fMax;
+
+	// Scale the value to the range of the bits and round it to the nearest step
+	WriteUInt((unsigned int)((((double)fIn - fMin) / ((double)fMax - fMin)) * uiMaxValue + 0.5), uiSizeInBits);
+}
+
+bool CBitStream::ReadQuantized(float &fOut, float fMin, float fMax, unsigned int uiSizeInBits)
+{
+	unsigned int uiValue;
+
+	if(!ReadUInt(uiValue, uiSizeInBits))
+		return false;
+
+	fOut = (float)(fMin + (((double)uiValue / ((1u << uiSizeInBits) - 1)) * ((double)fMax - fMin)));
+	return true;
+}
+
+void CBitStream::WriteNormVector(const CVector3 &vecIn, unsigned int uiSizeInBits)
+{
+	// Find the largest axis
+	float fAxes[3] = { vecIn.fX, vecIn.fY, vecIn.fZ };
+	unsigned int uiLargest = 0;
+
+	for(unsigned int i = 1; i < 3; i++)
+	{
+		if(fabs(fAxes[i]) > fabs(fAxes[uiLargest]))
+			uiLargest = i;
+	}
+
+	// Write the largest axis and its sign, it is rebuilt from the other two
+	WriteUInt(uiLargest, 2);
+	WriteBit(fAxes[uiLargest] < 0.0f);
+
+	// The other two axes can't be larger than 1 / sqrt(2)
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		if(i != uiLargest)
+			WriteQuantized(fAxes[i], -0.7072f, 0.7072f, uiSizeInBits);
+	}
+}
+
+bool CBitStream::ReadNormVector(CVector3 &vecOut, unsigned int uiSizeInBits)
+{
+	unsigned int uiLargest;
+
+	if(!ReadUInt(uiLargest, 2) || uiLargest > 2 || GetNumberOfUnreadBits() < 1)
+		return false;
+
+	bool bNegative = ReadBit();
+	float fAxes[3];
+	float fSquared = 0.0f;
+
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		if(i != uiLargest)
+		{
+			if(!ReadQuantized(fAxes[i], -0.7072f, 0.7072f, uiSizeInBits))
+				return false;
+
+			fSquared += (fAxes[i] * fAxes[i]);
+		}
+	}
+
+	// Rebuild the largest axis
+	fAxes[uiLargest] = (fSquared < 1.0f) ? sqrt(1.0f - fSquared) : 0.0f;
+
+	if(bNegative)
+		fAxes[uiLargest] = -fAxes[uiLargest];
+
+	vecOut = CVector3(fAxes[0], fAxes[1], fAxes[2]);
+	return true;
+}
+
+void CBitStream::WriteQuaternion(const float * fQuaternion, unsigned int uiSizeInBits)
+{
+	// Find the largest component
+	unsigned int uiLargest = 0;
+
+	for(unsigned int i = 1; i < 4; i++)
+	{
+		if(fabs(fQuaternion[i]) > fabs(fQuaternion[uiLargest]))
+			uiLargest = i;
+	}
+
+	// Write the largest component index, it is rebuilt from the other three
+	WriteUInt(uiLargest, 2);
+
+	// q and -q are the same rotation so flip the quaternion to make the largest component positive
+	float fSign = (fQuaternion[uiLargest] < 0.0f) ? -1.0f : 1.0f;
+
+	// The other three components can't be larger than 1 / sqrt(2)
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		if(i != uiLargest)
+			WriteQuantized((fQuaternion[i] * fSign), -0.7072f, 0.7072f, uiSizeInBits);
+	}
+}
+
+bool CBitStream::ReadQuaternion(float * fQuaternion, unsigned int uiSizeInBits)
+{
+	unsigned int uiLargest;
+
+	if(!ReadUInt(uiLargest, 2))
+		return false;
+
+	float fSquared = 0.0f;
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		if(i != uiLargest)
+		{
+			if(!ReadQuantized(fQuaternion[i], -0.7072f, 0.7072f, uiSizeInBits))
+				return false;
+
+			fSquared += (fQuaternion[i] * fQuaternion[i]);
+		}
+	}
+
+	// Rebuild the largest component
+	fQuaternion[uiLargest] = (fSquared < 1.0f) ? sqrt(1.0f - fSquared) : 0.0f;
+	return true;
+}
+
 void CBitStream::WriteBit(bool bState)
 {
 	if(bState)
@@ -14,6 +14,11 @@
 #include "../Math/CMath.h"
 #include "../Game/CControlState.h"
 
+struct OnFootSyncData;
+struct InVehicleSyncData;
+struct VehicleStateData;
+struct AimSyncData;
+
 #ifdef _LINUX
 #include <string.h>
 #include <stdlib.h>
@@ -105,6 +110,10 @@ public:
 	void                     Write(const String &strIn);
 	void                     Write(const CVector3 &vecIn);
 	void                     Write(const CControlState &in);
+	void                     Write(const OnFootSyncData &in);
+	void                     Write(const InVehicleSyncData &in);
+	void                     Write(const VehicleStateData &in);
+	void                     Write(const AimSyncData &in);
 
 	// Write any integral type compressed to the BitStream.
 	void                     WriteCompressed(const bool &bIn) { WRITE_COMPRESSED_TEMPLATE(sizeof(bool), bIn); }
@@ -134,6 +143,13 @@ public:
 	bool                     Read(String &strOut);
 	bool                     Read(CVector3 &vecOut);
 	bool                     Read(CControlState &out);
+	bool                     Read(OnFootSyncData &out);
+	bool                     Read(InVehicleSyncData &out);
+	bool                     Read(VehicleStateData &out);
+	bool                     Read(AimSyncData &out);
+
+	// Round the floats of vehicle state data to the values they have once they are written and read back.
+	static void              QuantizeVehicleState(VehicleStateData &data);
 
 	// Read any compressed integral type from the BitStream.
 	bool                     ReadCompressed(bool &bOut) { READ_COMPRESSED_TEMPLATE(sizeof(bool), bOut); }
@@ -168,6 +184,36 @@ public:
 	// Read a sequence of bits from the BitStream.
 	bool                     ReadBits(unsigned char * inOutByteArray, unsigned int numberOfBitsToRead, bool bAlignBitsToRight = true);
 
+	// Write all used bits of another BitStream to the BitStream.
+	void                     Write(const CBitStream * pBitStream);
+
+	// Read uiSizeInBits bits from the BitStream and write them to another BitStream.
+	bool                     Read(CBitStream * pBitStream, unsigned int uiSizeInBits);
+
+	// Write the lowest uiSizeInBits bits of an unsigned integer to the BitStream.
+	void                     WriteUInt(unsigned int uiIn, unsigned int uiSizeInBits);
+
+	// Read an unsigned integer of uiSizeInBits bits from the BitStream.
+	bool                     ReadUInt(unsigned int &uiOut, unsigned int uiSizeInBits);
+
+	// Write a float clamped to [fMin, fMax] and quantized to uiSizeInBits bits to the BitStream.
+	void                     WriteQuantized(float fIn, float fMin, float fMax, unsigned int uiSizeInBits);
+
+	// Read a float quantized with WriteQuantized from the BitStream.
+	bool                     ReadQuantized(float &fOut, float fMin, float fMax, unsigned int uiSizeInBits);
+
+	// Write a unit vector to the BitStream (largest axis, sign and the other two axes in uiSizeInBits bits each).
+	void                     WriteNormVector(const CVector3 &vecIn, unsigned int uiSizeInBits);
+
+	// Read a unit vector written with WriteNormVector from the BitStream.
+	bool                     ReadNormVector(CVector3 &vecOut, unsigned int uiSizeInBits);
+
+	// Write a unit quaternion (x, y, z, w) to the BitStream (largest component index and the other three in uiSizeInBits bits each).
+	void                     WriteQuaternion(const float * fQuaternion, unsigned int uiSizeInBits);
+
+	// Read a unit quaternion written with WriteQuaternion from the BitStream.
+	bool                     ReadQuaternion(float * fQuaternion, unsigned int uiSizeInBits);
+
 	// Write a 0 or 1 to the BitStream.
 	void                     WriteBit(bool bState);
 
@@ -11,6 +11,7 @@
 
 #include "CPacket.h"
 #include "CBitStream.h"
+#include "CNetStats.h"
 #include "PacketPriorities.h"
 #include "PacketReliabilities.h"
 #include "PacketChannels.h"
@@ -18,6 +19,17 @@
 
 typedef void (* PacketHandler_t)(CPacket * pPacket);
 
+// Statistics of the incoming packet path
+struct NetPacketStats
+{
+	// Packets passed to the packet handler
+	unsigned int uiPacketsReceived;
+
+	// Packets written to the capture file and packets replayed from a capture file
+	unsigned int uiPacketsCaptured;
+	unsigned int uiPacketsReplayed;
+};
+
 class CNetServerInterface
 {
 public:
@@ -26,10 +38,13 @@ public:
 	virtual bool            Startup(unsigned short usPort, int iMaxPlayers, String strHostAddress = "") = 0;
 	virtual void            Shutdown(int iBlockDuration) = 0;
 	virtual void            Process() = 0;
+	virtual bool            WaitForPackets(unsigned int uiTimeout) = 0;
 	virtual void            SetPassword(String strPassword) = 0;
 	virtual const char    * GetPassword() = 0;
 	virtual unsigned int    Send(CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel = PACKET_CHANNEL_DEFAULT) = 0;
 	virtual unsigned int    RPC(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, EntityId playerId, bool bBroadcast, char cOrderingChannel = PACKET_CHANNEL_DEFAULT) = 0;
+	virtual unsigned int    SendToMany(CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel = PACKET_CHANNEL_DEFAULT) = 0;
+	virtual unsigned int    RPCToMany(RPCIdentifier rpcId, CBitStream * pBitStream, ePacketPriority priority, ePacketReliability reliability, const EntityId * pPlayerIds, unsigned int uiPlayerCount, char cOrderingChannel = PACKET_CHANNEL_DEFAULT) = 0;
 	virtual const char    * GetPlayerIp(EntityId playerId) = 0;
 	virtual unsigned short  GetPlayerPort(EntityId playerId) = 0;
 	virtual void            SetPacketHandler(PacketHandler_t pfnPacketHandler) = 0;
@@ -37,9 +52,17 @@ public:
 	virtual const char    * GetPlayerSerial(EntityId playerId) = 0;
 	virtual void            KickPlayer(EntityId playerId, bool bSendDisconnectionNotification = true, ePacketPriority disconnectionPacketPriority = PRIORITY_LOW) = 0;
 	virtual CPlayerSocket * GetPlayerSocket(EntityId playerId) = 0;
+	virtual CPlayerSocket * GetPlayerSocket(EntityId playerId, unsigned int uiGeneration) = 0;
 	virtual bool            IsPlayerConnected(EntityId playerId) = 0;
 	virtual void            BanIp(String strIpAddress, unsigned int uiTimeMillseconds) = 0;
 	virtual void            UnbanIp(String strIpAddress) = 0;
 	virtual int             GetPlayerLastPing(EntityId playerId) = 0;
 	virtual int             GetPlayerAveragePing(EntityId playerId) = 0;
+	virtual void            GetPacketStats(NetPacketStats * pStats) = 0;
+	virtual bool            GetPlayerNetStats(EntityId playerId, CNetStats * pNetStats) = 0;
+	virtual bool            StartPacketCapture(String strFileName) = 0;
+	virtual void            StopPacketCapture() = 0;
+	virtual bool            StartPacketReplay(String strFileName, unsigned int uiTimeStep) = 0;
+	virtual void            StopPacketReplay() = 0;
+	virtual bool            IsReplayingPackets() = 0;
 };
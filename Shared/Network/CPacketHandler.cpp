@@ -8,71 +8,55 @@
 //==============================================================================
 
 #include "CPacketHandler.h"
+#include "../SharedUtility.h"
 
 CPacketHandler::CPacketHandler()
 {
+	// Reset the packet function table
+	memset(m_packetFunctions, 0, sizeof(m_packetFunctions));
 
+	for(int i = 0; i < MAX_PACKET_IDENTIFIERS; i++)
+		m_packetFunctions[i].packetId = (PacketIdentifier)i;
 }
 
 CPacketHandler::~CPacketHandler()
 {
-	std::list<PacketFunction *>::iterator iter;
 
-	for(iter = m_packetFunctionList.begin(); iter != m_packetFunctionList.end(); iter++)
-	{
-		delete (*iter);
-	}
 }
 
 void CPacketHandler::AddFunction(PacketIdentifier packetId, PacketFunction_t packetFunction)
 {
-	// Make sure it isn't already added
-	PacketFunction * pFunction = GetFunctionFromIdentifier(packetId);
+	PacketFunction * pFunction = &m_packetFunctions[packetId];
 
-	if(pFunction)
+	// Make sure it isn't already added
+	if(pFunction->packetFunction)
 	{
 		// Function already added
 		return;
 	}
 
-	// Create the packet function
-	pFunction = new PacketFunction;
-	pFunction->packetId = packetId;
+	// Set the packet function and reset its stats
 	pFunction->packetFunction = packetFunction;
-
-	// Add it to the packet function list
-	m_packetFunctionList.push_back(pFunction);
+	pFunction->uiCallCount = 0;
+	pFunction->ullBytes = 0;
+	pFunction->ullTime = 0;
 }
 
 void CPacketHandler::RemoveFunction(PacketIdentifier packetId)
 {
-	// Get the function
-	PacketFunction * pFunction = GetFunctionFromIdentifier(packetId);
-
-	// Is the function not added?
-	if(!pFunction)
-		return;
-
-	// Remove it from the packet function list
-	m_packetFunctionList.remove(pFunction);
-
-	// Delete it
-	delete pFunction;
+	// Reset the packet function
+	m_packetFunctions[packetId].packetFunction = NULL;
 }
 
 PacketFunction * CPacketHandler::GetFunctionFromIdentifier(PacketIdentifier packetId)
 {
-	// Iterate through all packet functions
-	std::list<PacketFunction *>::iterator iter;
-	for(iter = m_packetFunctionList.begin(); iter != m_packetFunctionList.end(); iter++)
-	{
-		// Is this the function we're after?
-		if((*iter)->packetId == packetId)
-			return (*iter);
-	}
+	PacketFunction * pFunction = &m_packetFunctions[packetId];
 
-	// Function not found
-	return NULL;
+	// Is the function not added?
+	if(!pFunction->packetFunction)
+		return NULL;
+
+	return pFunction;
 }
 
 bool CPacketHandler::HandlePacket(CPacket * pPacket)
@@ -84,12 +68,28 @@ bool CPacketHandler::HandlePacket(CPacket * pPacket)
 	{
 		// Construct the bit stream
 		CBitStream bitStream(pPacket->ucData, pPacket->uiLength, false);
+		unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
 
 		// Call the function
 		pFunction->packetFunction(&bitStream, pPacket->pPlayerSocket);
+
+		// Update the function stats
+		pFunction->uiCallCount++;
+		pFunction->ullBytes += pPacket->uiLength;
+		pFunction->ullTime += (SharedUtility::GetTimeMicroseconds() - ullStartTime);
 		return true;
 	}
 
 	// Not handled
 	return false;
 }
+
+void CPacketHandler::ResetStats()
+{
+	for(int i = 0; i < MAX_PACKET_IDENTIFIERS; i++)
+	{
+		m_packetFunctions[i].uiCallCount = 0;
+		m_packetFunctions[i].ullBytes = 0;
+		m_packetFunctions[i].ullTime = 0;
+	}
+}
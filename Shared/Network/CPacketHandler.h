@@ -9,26 +9,31 @@
 
 #pragma once
 
-#include <list>
 #include "CBitStream.h"
 #include "CPacket.h"
 
 // Type used for packet ids
 typedef unsigned char PacketIdentifier;
 
+// Amount of packet identifiers (packet ids are stored as an unsigned char)
+#define MAX_PACKET_IDENTIFIERS 256
+
 typedef void (* PacketFunction_t)(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 
 // Structure used for packet functions
 struct PacketFunction
 {
-	PacketIdentifier packetId;
-	PacketFunction_t packetFunction;
+	PacketIdentifier   packetId;
+	PacketFunction_t   packetFunction;
+	unsigned int       uiCallCount;
+	unsigned long long ullBytes;
+	unsigned long long ullTime;
 };
 
 class CPacketHandler
 {
 private:
-	std::list<PacketFunction *> m_packetFunctionList;
+	PacketFunction m_packetFunctions[MAX_PACKET_IDENTIFIERS];
 
 public:
 	CPacketHandler();
@@ -38,4 +43,5 @@ public:
 	void             RemoveFunction(PacketIdentifier packetId);
 	PacketFunction * GetFunctionFromIdentifier(PacketIdentifier packetId);
 	bool             HandlePacket(CPacket * pPacket);
+	void             ResetStats();
 };
@@ -35,12 +35,16 @@ public:
 	// The player serial
 	String strSerial;
 
+	// The generation of the player id, incremented each time the id is reused
+	unsigned int uiGeneration;
+
 	CPlayerSocket()
 	{
 		playerId = INVALID_ENTITY_ID;
 		ulBinaryAddress = 0xFFFFFFFF;
 		usPort = 0xFFFF;
 		strSerial.Set("00000000000000000000000000000000");
+		uiGeneration = 0;
 	}
 
 	EntityId       GetPlayerId() { return playerId; }
@@ -58,4 +62,5 @@ public:
 	}
 	unsigned short GetPort() { return usPort; }
 	String         GetSerial() { return strSerial; }
+	unsigned int   GetGeneration() { return uiGeneration; }
 };
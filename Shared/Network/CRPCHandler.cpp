@@ -9,71 +9,55 @@
 
 #include "CRPCHandler.h"
 #include "PacketIdentifiers.h"
+#include "../SharedUtility.h"
 
 CRPCHandler::CRPCHandler()
 {
+	// Reset the rpc function table
+	memset(m_rpcFunctions, 0, sizeof(m_rpcFunctions));
 
+	for(int i = 0; i < MAX_RPC_IDENTIFIERS; i++)
+		m_rpcFunctions[i].rpcId = (RPCIdentifier)i;
 }
 
 CRPCHandler::~CRPCHandler()
 {
-	std::list<RPCFunction *>::iterator iter;
 
-	for(iter = m_rpcFunctionList.begin(); iter != m_rpcFunctionList.end(); iter++)
-	{
-		delete (*iter);
-	}
 }
 
 void CRPCHandler::AddFunction(RPCIdentifier rpcId, RPCFunction_t rpcFunction)
 {
-	// Make sure it isn't already added
-	RPCFunction * pFunction = GetFunctionFromIdentifier(rpcId);
+	RPCFunction * pFunction = &m_rpcFunctions[rpcId];
 
-	if(pFunction)
+	// Make sure it isn't already added
+	if(pFunction->rpcFunction)
 	{
 		// Function already added
 		return;
 	}
 
-	// Create the rpc function
-	pFunction = new RPCFunction;
-	pFunction->rpcId = rpcId;
+	// Set the rpc function and reset its stats
 	pFunction->rpcFunction = rpcFunction;
-	
-	// Add it to the rpc function list
-	m_rpcFunctionList.push_back(pFunction);
+	pFunction->uiCallCount = 0;
+	pFunction->ullBytes = 0;
+	pFunction->ullTime = 0;
 }
 
 void CRPCHandler::RemoveFunction(RPCIdentifier rpcId)
 {
-	// Get the function
-	RPCFunction * pFunction = GetFunctionFromIdentifier(rpcId);
-
-	// Is the function not added?
-	if(!pFunction)
-		return;
-
-	// Remove it from the rpc function list
-	m_rpcFunctionList.remove(pFunction);
-
-	// Delete it
-	delete pFunction;
+	// Reset the rpc function
+	m_rpcFunctions[rpcId].rpcFunction = NULL;
 }
 
 RPCFunction * CRPCHandler::GetFunctionFromIdentifier(RPCIdentifier rpcId)
 {
-	// Iterate through all rpc functions
-	std::list<RPCFunction *>::iterator iter;
-	for(iter = m_rpcFunctionList.begin(); iter != m_rpcFunctionList.end(); iter++)
-	{
-		// Is this the function we're after?
-		if((*iter)->rpcId == rpcId)
-			return (*iter);
-	}
+	RPCFunction * pFunction = &m_rpcFunctions[rpcId];
+
+	// Is the function not added?
+	if(!pFunction->rpcFunction)
+		return NULL;
 
-	// Function not found
-	return NULL;
+	return pFunction;
 }
 
 bool CRPCHandler::HandlePacket(CPacket * pPacket)
@@ -93,8 +77,15 @@ bool CRPCHandler::HandlePacket(CPacket * pPacket)
 			// Does the function exist?
 			if(pFunction)
 			{
+				unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+
 				// Call the function
 				pFunction->rpcFunction(&bitStream, pPacket->pPlayerSocket);
+
+				// Update the function stats
+				pFunction->uiCallCount++;
+				pFunction->ullBytes += pPacket->uiLength;
+				pFunction->ullTime += (SharedUtility::GetTimeMicroseconds() - ullStartTime);
 				return true;
 			}
 		}
@@ -103,3 +94,13 @@ bool CRPCHandler::HandlePacket(CPacket * pPacket)
 	// Not handled
 	return false;
 }
+
+void CRPCHandler::ResetStats()
+{
+	for(int i = 0; i < MAX_RPC_IDENTIFIERS; i++)
+	{
+		m_rpcFunctions[i].uiCallCount = 0;
+		m_rpcFunctions[i].ullBytes = 0;
+		m_rpcFunctions[i].ullTime = 0;
+	}
+}
@@ -9,25 +9,30 @@
 
 #pragma once
 
-#include <list>
 #include "CBitStream.h"
 #include "CPlayerSocket.h"
 #include "RPCIdentifiers.h"
 #include "CPacket.h"
 
+// Amount of rpc identifiers (rpc ids are stored as an unsigned char)
+#define MAX_RPC_IDENTIFIERS 256
+
 typedef void (* RPCFunction_t)(CBitStream * pBitStream, CPlayerSocket * pSenderSocket);
 
 // Structure used for rpc functions
 struct RPCFunction
 {
-	RPCIdentifier rpcId;
-	RPCFunction_t rpcFunction;
+	RPCIdentifier      rpcId;
+	RPCFunction_t      rpcFunction;
+	unsigned int       uiCallCount;
+	unsigned long long ullBytes;
+	unsigned long long ullTime;
 };
 
 class CRPCHandler
 {
 private:
-	std::list<RPCFunction *> m_rpcFunctionList;
+	RPCFunction m_rpcFunctions[MAX_RPC_IDENTIFIERS];
 
 public:
 	CRPCHandler();
@@ -37,4 +42,5 @@ public:
 	void          RemoveFunction(RPCIdentifier rpcId);
 	RPCFunction * GetFunctionFromIdentifier(RPCIdentifier rpcId);
 	bool          HandlePacket(CPacket * pPacket);
+	void          ResetStats();
 };
@@ -9,9 +9,11 @@
 
 #pragma once
 
+#include "RPCIdentifiers.h"
+
 enum ePacketChannels
 {
-	// Default packet channel
+	// Default packet channel (rpcs sent on it are moved to the channel of their rpc id)
 	PACKET_CHANNEL_DEFAULT,
 
 	// Packet channel used for input
@@ -20,6 +22,51 @@ enum ePacketChannels
 	// Packet channel used for script
 	PACKET_CHANNEL_SCRIPT,
 
+	// Packet channel used for world state (entities and their properties)
+	PACKET_CHANNEL_WORLD,
+
+	// Packet channel used for chat
+	PACKET_CHANNEL_CHAT,
+
+	// Packet channel used for file management
+	PACKET_CHANNEL_FILE,
+
+	// Packet channel used for connection management
+	PACKET_CHANNEL_ADMIN,
+
 	// Number of packet channels
 	PACKET_CHANNEL_COUNT
 };
+
+// Get the packet channel an rpc is sent on, each channel is ordered on its own so
+// a lost packet on one of them doesn't hold back the packets on the others
+inline char GetRPCChannel(RPCIdentifier rpcId)
+{
+	switch(rpcId)
+	{
+	case RPC_OnFootSync:
+	case RPC_InVehicleSync:
+	case RPC_PassengerSync:
+	case RPC_SmallSync:
+	case RPC_EmptyVehicleSync:
+	case RPC_BatchedSync:
+	case RPC_HeadMovement:
+	case RPC_SyncActor:
+	case RPC_RequestActorUpdate:
+		return PACKET_CHANNEL_INPUT;
+	case RPC_Message:
+	case RPC_Chat:
+	case RPC_Command:
+		return PACKET_CHANNEL_CHAT;
+	case RPC_ScriptingEventCall:
+		return PACKET_CHANNEL_SCRIPT;
+	case RPC_NewFile:
+	case RPC_DeleteFile:
+		return PACKET_CHANNEL_FILE;
+	case RPC_PlayerConnect:
+	case RPC_ConnectionRefused:
+		return PACKET_CHANNEL_ADMIN;
+	}
+
+	return PACKET_CHANNEL_WORLD;
+}
@@ -56,6 +56,9 @@ enum eRPCIdentfiers
 	RPC_DeletePickup,
 	RPC_SyncActor,
 	RPC_RequestActorUpdate,
+	RPC_VehicleState,
+	RPC_BatchedSync,
+	RPC_WorldSnapshot,
 
 	// Scripting RPC's
 	RPC_ScriptingTogglePayAndSpray,
@@ -0,0 +1,401 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CScriptProfiler.cpp
+// Project: Shared
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#include "CScriptProfiler.h"
+#include "CScriptingManager.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <Squirrel/sqstate.h>
+#include <Squirrel/sqvm.h>
+#include <Squirrel/sqstring.h>
+#include <Squirrel/sqfuncproto.h>
+#include <Squirrel/sqclosure.h>
+#include "../SharedUtility.h"
+
+extern CScriptingManager * g_pScriptingManager;
+
+CScriptProfiler * g_pScriptProfiler = NULL;
+
+// Sort the report by exclusive time (most expensive first)
+static bool SortStatsByExclusiveTime(ScriptProfileStats * a, ScriptProfileStats * b)
+{
+	return (a->ullExclusive > b->ullExclusive);
+}
+
+// Sort the contexts of the report by inclusive time (most expensive first)
+static bool SortStatsByInclusiveTime(ScriptProfileStats * a, ScriptProfileStats * b)
+{
+	return (a->ullInclusive > b->ullInclusive);
+}
+
+CScriptProfiler::CScriptProfiler()
+{
+	m_bActive = false;
+	Reset();
+}
+
+CScriptProfiler::~CScriptProfiler()
+{
+	Stop();
+}
+
+void CScriptProfiler::DebugHook(HSQUIRRELVM /*pVM*/, SQInteger iType, const SQChar * szSource, SQInteger iLine, const SQChar * szFunction)
+{
+	// Threads (coroutines) copy the hook of the vm which created them and aren't unhooked on stop
+	if(!g_pScriptProfiler || !g_pScriptProfiler->IsActive())
+		return;
+
+	// We only need the calls and returns, line events are only sent by scripts with debug info
+	if(iType == 'c')
+		g_pScriptProfiler->EnterFunction(szSource, iLine, szFunction);
+	else if(iType == 'r')
+		g_pScriptProfiler->LeaveFunction();
+}
+
+unsigned int CScriptProfiler::GetFunction(String strName, bool bContext)
+{
+	std::map<String, unsigned int>::iterator iter = m_functionNames.find(strName);
+
+	if(iter != m_functionNames.end())
+		return (*iter).second;
+
+	ScriptProfileFunction function;
+	function.strName = strName;
+	function.bContext = bContext;
+	m_functions.push_back(function);
+
+	unsigned int uiFunction = (unsigned int)(m_functions.size() - 1);
+	m_functionNames[strName] = uiFunction;
+	return uiFunction;
+}
+
+unsigned int CScriptProfiler::GetStats(unsigned int uiContext, unsigned int uiFunction)
+{
+	unsigned long long ullKey = (((unsigned long long)uiContext << 32) | uiFunction);
+	std::map<unsigned long long, unsigned int>::iterator iter = m_statsIds.find(ullKey);
+
+	if(iter != m_statsIds.end())
+		return (*iter).second;
+
+	ScriptProfileStats stats;
+	memset(&stats, 0, sizeof(ScriptProfileStats));
+	stats.uiContext = uiContext;
+	stats.uiFunction = uiFunction;
+	m_stats.push_back(stats);
+
+	unsigned int uiStats = (unsigned int)(m_stats.size() - 1);
+	m_statsIds[ullKey] = uiStats;
+	return uiStats;
+}
+
+unsigned int CScriptProfiler::GetChildNode(unsigned int uiParent, unsigned int uiFunction)
+{
+	std::map<unsigned int, unsigned int>::iterator iter = m_nodes[uiParent].children.find(uiFunction);
+
+	if(iter != m_nodes[uiParent].children.end())
+		return (*iter).second;
+
+	ScriptProfileNode node;
+	node.uiFunction = uiFunction;
+	node.uiParent = uiParent;
+	node.uiCalls = 0;
+	node.ullInclusive = 0;
+	node.ullExclusive = 0;
+
+	// Contexts start a new group, functions belong to the group of their caller
+	if(m_functions[uiFunction].bContext)
+		node.uiStats = GetStats(uiFunction, uiFunction);
+	else
+		node.uiStats = GetStats(m_stats[m_nodes[uiParent].uiStats].uiContext, uiFunction);
+
+	// Add the node (this may move the nodes so don't keep references to them across this)
+	m_nodes.push_back(node);
+	unsigned int uiNode = (unsigned int)(m_nodes.size() - 1);
+	m_nodes[uiParent].children[uiFunction] = uiNode;
+	return uiNode;
+}
+
+void CScriptProfiler::PushFrame(unsigned int uiNode, unsigned long long ullTime)
+{
+	ScriptProfileNode * pNode = &m_nodes[uiNode];
+	ScriptProfileStats * pStats = &m_stats[pNode->uiStats];
+	pNode->uiCalls++;
+	pStats->uiCalls++;
+	pStats->uiActive++;
+	m_uiCallCount++;
+
+	ScriptProfileFrame frame;
+	frame.uiNode = uiNode;
+	frame.ullStartTime = ullTime;
+	frame.ullChildTime = 0;
+	m_frames.push_back(frame);
+}
+
+void CScriptProfiler::PopFrame(unsigned long long ullTime)
+{
+	ScriptProfileFrame frame = m_frames.back();
+	m_frames.pop_back();
+
+	ScriptProfileNode * pNode = &m_nodes[frame.uiNode];
+	ScriptProfileStats * pStats = &m_stats[pNode->uiStats];
+	unsigned long long ullInclusive = (ullTime - frame.ullStartTime);
+	unsigned long long ullExclusive = (ullInclusive - frame.ullChildTime);
+	pNode->ullInclusive += ullInclusive;
+	pNode->ullExclusive += ullExclusive;
+	pStats->ullExclusive += ullExclusive;
+
+	// Only count the inclusive time of the outermost call of recursive functions
+	if(--pStats->uiActive == 0)
+		pStats->ullInclusive += ullInclusive;
+
+	if(!m_frames.empty())
+		m_frames.back().ullChildTime += ullInclusive;
+	else if(pNode->uiParent == m_uiScriptNode)
+	{
+		// Calls outside of any event or timer (e.g. the script body) are grouped as one context
+		ScriptProfileStats * pScriptStats = &m_stats[m_nodes[m_uiScriptNode].uiStats];
+		pScriptStats->uiCalls++;
+		pScriptStats->ullInclusive += ullInclusive;
+		m_nodes[m_uiScriptNode].uiCalls++;
+		m_nodes[m_uiScriptNode].ullInclusive += ullInclusive;
+	}
+}
+
+void CScriptProfiler::EnterFunction(const SQChar * szSource, SQInteger iLine, const SQChar * szFunction)
+{
+	unsigned long long ullTime = SharedUtility::GetTimeMicroseconds();
+
+	// Get the function from the cache or add it
+	ScriptProfileKey key;
+	key.szSource = szSource;
+	key.szFunction = szFunction;
+	key.iLine = iLine;
+	unsigned int uiFunction;
+	std::map<ScriptProfileKey, unsigned int>::iterator iter = m_functionCache.find(key);
+
+	if(iter != m_functionCache.end())
+		uiFunction = (*iter).second;
+	else
+	{
+		String strName("%s (%s:%d)", (szFunction ? szFunction : "unknown"), (szSource ? szSource : "unknown"), (int)iLine);
+		uiFunction = GetFunction(strName, false);
+		m_functionCache[key] = uiFunction;
+	}
+
+	unsigned int uiParent = (m_frames.empty() ? m_uiScriptNode : m_frames.back().uiNode);
+	PushFrame(GetChildNode(uiParent, uiFunction), ullTime);
+}
+
+void CScriptProfiler::LeaveFunction()
+{
+	// Ignore returns from calls we didn't see start (e.g. calls already running when the profiler started)
+	if(m_frames.empty() || m_functions[m_nodes[m_frames.back().uiNode].uiFunction].bContext)
+		return;
+
+	PopFrame(SharedUtility::GetTimeMicroseconds());
+}
+
+String CScriptProfiler::GetStackName(unsigned int uiNode)
+{
+	// Build the folded call stack (root first, frames separated by ';')
+	String strStack;
+
+	for(; uiNode != 0; uiNode = m_nodes[uiNode].uiParent)
+	{
+		if(strStack.IsEmpty())
+			strStack = m_functions[m_nodes[uiNode].uiFunction].strName;
+		else
+			strStack = m_functions[m_nodes[uiNode].uiFunction].strName + ";" + strStack;
+	}
+
+	return strStack;
+}
+
+void CScriptProfiler::Start()
+{
+	if(m_bActive)
+		return;
+
+	// Start a new profile
+	Reset();
+	m_bActive = true;
+	m_ullStartTime = SharedUtility::GetTimeMicroseconds();
+
+	// Hook all loaded scripts
+	for(std::list<CSquirrel *>::iterator iter = g_pScriptingManager->GetScriptList()->begin(); iter != g_pScriptingManager->GetScriptList()->end(); iter++)
+		HandleScriptLoad((*iter)->GetVM());
+}
+
+void CScriptProfiler::Stop()
+{
+	if(!m_bActive)
+		return;
+
+	// Unhook all loaded scripts
+	if(g_pScriptingManager)
+	{
+		for(std::list<CSquirrel *>::iterator iter = g_pScriptingManager->GetScriptList()->begin(); iter != g_pScriptingManager->GetScriptList()->end(); iter++)
+			sq_setnativedebughook((*iter)->GetVM(), NULL);
+	}
+
+	// Finish anything still running
+	unsigned long long ullTime = SharedUtility::GetTimeMicroseconds();
+
+	while(!m_frames.empty())
+		PopFrame(ullTime);
+
+	m_ullProfileTime = (ullTime - m_ullStartTime);
+	m_bActive = false;
+}
+
+void CScriptProfiler::Reset()
+{
+	m_ullStartTime = SharedUtility::GetTimeMicroseconds();
+	m_ullProfileTime = 0;
+	m_uiCallCount = 0;
+	m_functions.clear();
+	m_nodes.clear();
+	m_stats.clear();
+	m_frames.clear();
+	m_functionCache.clear();
+	m_functionNames.clear();
+	m_statsIds.clear();
+
+	// Add the root node and the node of calls outside of any event or timer
+	ScriptProfileNode root;
+	root.uiFunction = GetFunction("[root]", true);
+	root.uiParent = 0;
+	root.uiStats = GetStats(root.uiFunction, root.uiFunction);
+	root.uiCalls = 0;
+	root.ullInclusive = 0;
+	root.ullExclusive = 0;
+	m_nodes.push_back(root);
+	m_uiScriptNode = GetChildNode(0, GetFunction("[script]", true));
+}
+
+void CScriptProfiler::HandleScriptLoad(SQVM * pVM)
+{
+	if(m_bActive && pVM)
+		sq_setnativedebughook(pVM, DebugHook);
+}
+
+void CScriptProfiler::HandleScriptUnload()
+{
+	// The strings of the script are freed with the vm, so its function keys could be reused by another script
+	m_functionCache.clear();
+}
+
+void CScriptProfiler::PushContext(String strName)
+{
+	unsigned int uiParent = (m_frames.empty() ? 0 : m_frames.back().uiNode);
+	PushFrame(GetChildNode(uiParent, GetFunction(strName, true)), SharedUtility::GetTimeMicroseconds());
+}
+
+void CScriptProfiler::PopContext()
+{
+	unsigned long long ullTime = SharedUtility::GetTimeMicroseconds();
+
+	// Pop the frames up to and including the context (a script error unwinds without returns)
+	while(!m_frames.empty())
+	{
+		bool bContext = m_functions[m_nodes[m_frames.back().uiNode].uiFunction].bContext;
+		PopFrame(ullTime);
+
+		if(bContext)
+			break;
+	}
+}
+
+bool CScriptProfiler::WriteReport(const char * szFileName)
+{
+	FILE * pFile = fopen(szFileName, "w");
+
+	if(!pFile)
+		return false;
+
+	// Split the stats into the contexts and their functions
+	std::vector<ScriptProfileStats *> contexts;
+	std::vector<ScriptProfileStats *> functions;
+
+	for(std::vector<ScriptProfileStats>::iterator iter = m_stats.begin(); iter != m_stats.end(); ++ iter)
+	{
+		if((*iter).uiCalls == 0)
+			continue;
+
+		if((*iter).uiContext == (*iter).uiFunction)
+			contexts.push_back(&(*iter));
+		else
+			functions.push_back(&(*iter));
+	}
+
+	std::sort(contexts.begin(), contexts.end(), SortStatsByInclusiveTime);
+	std::sort(functions.begin(), functions.end(), SortStatsByExclusiveTime);
+
+	fprintf(pFile, "Script profile: %llu ms, %u call(s) (times in us)\n", (GetProfileTime() / 1000), m_uiCallCount);
+
+	for(std::vector<ScriptProfileStats *>::iterator iter = contexts.begin(); iter != contexts.end(); ++ iter)
+	{
+		ScriptProfileStats * pContext = (*iter);
+		fprintf(pFile, "\n%s: %u call(s) %llu us\n", m_functions[pContext->uiFunction].strName.Get(), pContext->uiCalls, pContext->ullInclusive);
+		fprintf(pFile, "  %10s %12s %12s %10s  %s\n", "calls", "inclusive", "exclusive", "avg", "function");
+
+		for(std::vector<ScriptProfileStats *>::iterator iter2 = functions.begin(); iter2 != functions.end(); ++ iter2)
+		{
+			ScriptProfileStats * pStats = (*iter2);
+
+			if(pStats->uiContext == pContext->uiFunction)
+			{
+				fprintf(pFile, "  %10u %12llu %12llu %10llu  %s\n", pStats->uiCalls, pStats->ullInclusive, pStats->ullExclusive,
+					(pStats->ullInclusive / pStats->uiCalls), m_functions[pStats->uiFunction].strName.Get());
+			}
+		}
+	}
+
+	fclose(pFile);
+	return true;
+}
+
+bool CScriptProfiler::WriteFoldedStacks(const char * szFileName)
+{
+	FILE * pFile = fopen(szFileName, "w");
+
+	if(!pFile)
+		return false;
+
+	// One line per call stack with the exclusive time of its last frame (the format of flamegraph.pl)
+	for(unsigned int i = 1; i < m_nodes.size(); i++)
+	{
+		if(m_nodes[i].ullExclusive > 0)
+			fprintf(pFile, "%s %llu\n", GetStackName(i).Get(), m_nodes[i].ullExclusive);
+	}
+
+	fclose(pFile);
+	return true;
+}
+
+unsigned long long CScriptProfiler::GetProfileTime()
+{
+	if(m_bActive)
+		return (SharedUtility::GetTimeMicroseconds() - m_ullStartTime);
+
+	return m_ullProfileTime;
+}
+
+String CScriptProfiler::GetClosureName(SQObjectPtr pFunction)
+{
+	const SQChar * szName = NULL;
+
+	if(type(pFunction) == OT_CLOSURE && type(_closure(pFunction)->_function->_name) == OT_STRING)
+		szName = _stringval(_closure(pFunction)->_function->_name);
+	else if(type(pFunction) == OT_NATIVECLOSURE && type(_nativeclosure(pFunction)->_name) == OT_STRING)
+		szName = _stringval(_nativeclosure(pFunction)->_name);
+
+	return String("%s", (szName ? szName : "unknown"));
+}
@@ -0,0 +1,120 @@
+//============== IV: Multiplayer - http://code.iv-multiplayer.com ==============
+//
+// File: CScriptProfiler.h
+// Project: Shared
+// Author(s): jenksta
+// License: See LICENSE in root directory
+//
+//==============================================================================
+
+#pragma once
+
+#include "CSquirrel.h"
+#include <map>
+#include <vector>
+
+// Function (or event/timer context) the profiler attributes time to
+struct ScriptProfileFunction
+{
+	String       strName;
+	bool         bContext;
+};
+
+// Call tree node, a function called from one specific call stack
+struct ScriptProfileNode
+{
+	unsigned int                         uiFunction;
+	unsigned int                         uiParent;
+	unsigned int                         uiStats;
+	unsigned int                         uiCalls;
+	unsigned long long                   ullInclusive;
+	unsigned long long                   ullExclusive;
+	std::map<unsigned int, unsigned int> children;
+};
+
+// Stats of a function within one context (all call stacks merged)
+struct ScriptProfileStats
+{
+	unsigned int       uiContext;
+	unsigned int       uiFunction;
+	unsigned int       uiCalls;
+	unsigned int       uiActive;
+	unsigned long long ullInclusive;
+	unsigned long long ullExclusive;
+};
+
+// Function or context currently on the profiler call stack
+struct ScriptProfileFrame
+{
+	unsigned int       uiNode;
+	unsigned long long ullStartTime;
+	unsigned long long ullChildTime;
+};
+
+// Identifies a function by the strings the debug hook passes (the strings are interned by the vm
+// so the pointers stay the same while the script is loaded)
+struct ScriptProfileKey
+{
+	const SQChar * szSource;
+	const SQChar * szFunction;
+	SQInteger      iLine;
+
+	bool operator<(const ScriptProfileKey& other) const
+	{
+		if(szSource != other.szSource)
+			return (szSource < other.szSource);
+
+		if(szFunction != other.szFunction)
+			return (szFunction < other.szFunction);
+
+		return (iLine < other.iLine);
+	}
+};
+
+// Opt-in profiler which uses the squirrel debug hook to attribute time and calls to script functions
+class CScriptProfiler
+{
+private:
+	bool                                          m_bActive;
+	unsigned long long                            m_ullStartTime;
+	unsigned long long                            m_ullProfileTime;
+	unsigned int                                  m_uiCallCount;
+	unsigned int                                  m_uiScriptNode;
+	std::vector<ScriptProfileFunction>            m_functions;
+	std::vector<ScriptProfileNode>                m_nodes;
+	std::vector<ScriptProfileStats>               m_stats;
+	std::vector<ScriptProfileFrame>               m_frames;
+	std::map<ScriptProfileKey, unsigned int>      m_functionCache;
+	std::map<String, unsigned int>                m_functionNames;
+	std::map<unsigned long long, unsigned int>    m_statsIds;
+
+	static void         DebugHook(HSQUIRRELVM /*pVM*/, SQInteger iType, const SQChar * szSource, SQInteger iLine, const SQChar * szFunction);
+
+	unsigned int        GetFunction(String strName, bool bContext);
+	unsigned int        GetStats(unsigned int uiContext, unsigned int uiFunction);
+	unsigned int        GetChildNode(unsigned int uiParent, unsigned int uiFunction);
+	void                PushFrame(unsigned int uiNode, unsigned long long ullTime);
+	void                PopFrame(unsigned long long ullTime);
+	void                EnterFunction(const SQChar * szSource, SQInteger iLine, const SQChar * szFunction);
+	void                LeaveFunction();
+	String              GetStackName(unsigned int uiNode);
+
+public:
+	CScriptProfiler();
+	~CScriptProfiler();
+
+	bool                IsActive() { return m_bActive; }
+	void                Start();
+	void                Stop();
+	void                Reset();
+	void                HandleScriptLoad(SQVM * pVM);
+	void                HandleScriptUnload();
+	void                PushContext(String strName);
+	void                PopContext();
+	bool                WriteReport(const char * szFileName);
+	bool                WriteFoldedStacks(const char * szFileName);
+	unsigned int        GetCallCount() { return m_uiCallCount; }
+	unsigned long long  GetProfileTime();
+
+	static String       GetClosureName(SQObjectPtr pFunction);
+};
@@ -20,6 +20,8 @@ CScriptTimer::CScriptTimer(CSquirrel* pSquirrel, SQObjectPtr pFunction, int uiIn
 	m_pArguments = pArguments;
 	m_uiLastTick = SharedUtility::GetTime();
 	m_bTraditional = false;
+	m_uiTimerId = 0;
+	m_pWheelSlot = NULL;
 }
 
 CScriptTimer::~CScriptTimer()
@@ -28,7 +30,7 @@ CScriptTimer::~CScriptTimer()
 		delete m_pArguments;
 }
 
-bool CScriptTimer::Pulse()
+bool CScriptTimer::Pulse(unsigned int uiNow)
 {
 	if(m_bIsDead)
 		return false;
@@ -37,11 +39,8 @@ bool CScriptTimer::Pulse()
 	// 'traditional behavior' means only one iteration at most
 	unsigned int iCount = m_bTraditional ? 1 : 10;
 
-	// save the current time
-	unsigned int uiNow = SharedUtility::GetTime();
-
-	// call the timer function as long as we should by time & iterations
-	while(uiNow >= m_uiLastTick + m_uiInterval && iCount -- > 0)
+	// call the timer function as long as we should by time & iterations (compared so the time can wrap around)
+	while((int)(uiNow - (m_uiLastTick + m_uiInterval)) >= 0 && iCount -- > 0)
 	{
 		// call the function
 		m_pSquirrel->Call(m_pFunction, m_pArguments);
@@ -60,6 +59,21 @@ bool CScriptTimer::Pulse()
 	return true;
 }
 
+unsigned int CScriptTimer::GetNextTick()
+{
+	return (m_uiLastTick + m_uiInterval);
+}
+
+unsigned int CScriptTimer::GetTimerId()
+{
+	return m_uiTimerId;
+}
+
+SQObjectPtr CScriptTimer::GetFunction()
+{
+	return m_pFunction;
+}
+
 CSquirrel* CScriptTimer::GetScript()
 {
 	return m_pSquirrel;
@@ -11,9 +11,12 @@
 
 #include "CSquirrel.h"
 #include "CSquirrelArguments.h"
+#include <list>
 
 class CScriptTimer
 {
+	friend class CScriptTimerManager;
+
 private:
 	CSquirrel* m_pSquirrel;
 	SQObjectPtr m_pFunction;
@@ -24,11 +27,19 @@ private:
 	bool m_bIsDead;
 	bool m_bTraditional;
 
+	// Set by the timer manager
+	unsigned int m_uiTimerId;
+	std::list<CScriptTimer *> * m_pWheelSlot;
+	std::list<CScriptTimer *>::iterator m_wheelIterator;
+
 public:
 	CScriptTimer(CSquirrel* pSquirrel, SQObjectPtr pFunction, int uiInterval, int iRepeations, CSquirrelArguments* pArguments);
 	~CScriptTimer();
 
-	bool Pulse();
+	bool Pulse(unsigned int uiNow);
+	unsigned int GetNextTick();
+	unsigned int GetTimerId();
+	SQObjectPtr GetFunction();
 	CSquirrel* GetScript();
 	void Kill();
 	bool IsDead();
@@ -10,43 +10,186 @@
 //==============================================================================
 
 #include "CScriptTimerManager.h"
+#include "CScriptProfiler.h"
+#include "../SharedUtility.h"
 
 CScriptTimerManager * g_pScriptTimerManager = NULL;
+extern CScriptProfiler * g_pScriptProfiler;
 
-void CScriptTimerManager::Pulse()
+CScriptTimerManager::CScriptTimerManager()
+{
+	m_uiNextTimerId = 1;
+	m_uiWheelTime = SharedUtility::GetTime();
+}
+
+CScriptTimerManager::~CScriptTimerManager()
 {
-	for(iterator iter = begin(); iter != end(); )
+	for(std::map<unsigned int, CScriptTimer *>::iterator iter = m_timers.begin(); iter != m_timers.end(); ++ iter)
+		delete (*iter).second;
+}
+
+void CScriptTimerManager::Schedule(CScriptTimer * pTimer)
+{
+	unsigned int uiTime = pTimer->GetNextTick();
+	unsigned int uiDelta = (uiTime - m_uiWheelTime);
+	TimerWheelSlot * pSlot = NULL;
+
+	if((int)uiDelta < 0)
 	{
-		if(!(*iter)->Pulse())
+		// Already due, run it on the next slot
+		pSlot = &m_rootSlots[m_uiWheelTime & TIMER_WHEEL_ROOT_MASK];
+	}
+	else if(uiDelta < TIMER_WHEEL_ROOT_SIZE)
+		pSlot = &m_rootSlots[uiTime & TIMER_WHEEL_ROOT_MASK];
+	else
+	{
+		// Find the first outer level which covers the delta
+		for(int i = 0; i < TIMER_WHEEL_LEVELS; i++)
 		{
-			delete *iter;
-			iter = erase(iter);
+			unsigned int uiShift = (TIMER_WHEEL_ROOT_BITS + (i * TIMER_WHEEL_LEVEL_BITS));
+
+			if(i == (TIMER_WHEEL_LEVELS - 1) || uiDelta < (1u << (uiShift + TIMER_WHEEL_LEVEL_BITS)))
+			{
+				pSlot = &m_levelSlots[i][(uiTime >> uiShift) & TIMER_WHEEL_LEVEL_MASK];
+				break;
+			}
 		}
-		else
-			++ iter;
 	}
+
+	pTimer->m_wheelIterator = pSlot->insert(pSlot->end(), pTimer);
+	pTimer->m_pWheelSlot = pSlot;
 }
 
-void CScriptTimerManager::HandleScriptUnload(CSquirrel * pScript)
+void CScriptTimerManager::Unschedule(CScriptTimer * pTimer)
 {
-	for(iterator iter = begin(); iter != end(); )
+	if(pTimer->m_pWheelSlot)
 	{
-		if((*iter)->GetScript() == pScript)
+		pTimer->m_pWheelSlot->erase(pTimer->m_wheelIterator);
+		pTimer->m_pWheelSlot = NULL;
+	}
+}
+
+unsigned int CScriptTimerManager::Cascade(int iLevel)
+{
+	// Move the timers of the current slot of this level down to the levels below
+	unsigned int uiIndex = ((m_uiWheelTime >> (TIMER_WHEEL_ROOT_BITS + (iLevel * TIMER_WHEEL_LEVEL_BITS))) & TIMER_WHEEL_LEVEL_MASK);
+	TimerWheelSlot slot;
+	slot.swap(m_levelSlots[iLevel][uiIndex]);
+
+	for(TimerWheelSlot::iterator iter = slot.begin(); iter != slot.end(); ++ iter)
+		Schedule(*iter);
+
+	return uiIndex;
+}
+
+void CScriptTimerManager::Delete(CScriptTimer * pTimer)
+{
+	Unschedule(pTimer);
+	m_timers.erase(pTimer->GetTimerId());
+	delete pTimer;
+}
+
+unsigned int CScriptTimerManager::Add(CScriptTimer * pTimer)
+{
+	// Move the wheel on to now if it has been idle
+	if(m_timers.empty())
+		m_uiWheelTime = SharedUtility::GetTime();
+
+	// Get a free timer id (0 is never used so it can mean no timer)
+	while(m_uiNextTimerId == 0 || m_timers.find(m_uiNextTimerId) != m_timers.end())
+		m_uiNextTimerId++;
+
+	pTimer->m_uiTimerId = m_uiNextTimerId++;
+	m_timers[pTimer->GetTimerId()] = pTimer;
+	Schedule(pTimer);
+	return pTimer->GetTimerId();
+}
+
+CScriptTimer * CScriptTimerManager::Get(unsigned int uiTimerId)
+{
+	std::map<unsigned int, CScriptTimer *>::iterator iter = m_timers.find(uiTimerId);
+
+	if(iter != m_timers.end())
+		return (*iter).second;
+
+	return NULL;
+}
+
+void CScriptTimerManager::Kill(CScriptTimer * pTimer)
+{
+	// Is the timer running right now? (it is deleted once it returns)
+	if(!pTimer->m_pWheelSlot)
+	{
+		pTimer->Kill();
+		return;
+	}
+
+	Delete(pTimer);
+}
+
+void CScriptTimerManager::Pulse()
+{
+	unsigned int uiNow = SharedUtility::GetTime();
+
+	// Move the wheel on until it has reached now and collect the timers which are due
+	while((int)(uiNow - m_uiWheelTime) >= 0)
+	{
+		unsigned int uiIndex = (m_uiWheelTime & TIMER_WHEEL_ROOT_MASK);
+
+		// Has the root level wrapped? if so cascade the outer levels down
+		if(uiIndex == 0)
 		{
-			delete *iter;
-			iter = erase(iter);
+			for(int i = 0; i < TIMER_WHEEL_LEVELS; i++)
+			{
+				if(Cascade(i) != 0)
+					break;
+			}
 		}
+
+		TimerWheelSlot * pSlot = &m_rootSlots[uiIndex];
+
+		for(TimerWheelSlot::iterator iter = pSlot->begin(); iter != pSlot->end(); ++ iter)
+			(*iter)->m_pWheelSlot = &m_dueTimers;
+
+		m_dueTimers.splice(m_dueTimers.end(), *pSlot);
+		m_uiWheelTime++;
+	}
+
+	// Run the timers which are due
+	while(!m_dueTimers.empty())
+	{
+		CScriptTimer * pTimer = m_dueTimers.front();
+		m_dueTimers.pop_front();
+
+		// The timer isn't scheduled while it runs, killing it now only marks it as dead
+		pTimer->m_pWheelSlot = NULL;
+
+		// Attribute the time of the timer function to the timer while the script profiler runs
+		bool bProfile = (g_pScriptProfiler && g_pScriptProfiler->IsActive());
+
+		if(bProfile)
+			g_pScriptProfiler->PushContext(String("timer %s", CScriptProfiler::GetClosureName(pTimer->GetFunction()).Get()));
+
+		bool bAlive = pTimer->Pulse(uiNow);
+
+		if(bProfile)
+			g_pScriptProfiler->PopContext();
+
+		if(!bAlive || pTimer->IsDead())
+			Delete(pTimer);
 		else
-			++ iter;
+			Schedule(pTimer);
 	}
 }
 
-// this basically means the CScriptTimer* pointer is valid as well
-bool CScriptTimerManager::contains(CScriptTimer* pTimer)
+void CScriptTimerManager::HandleScriptUnload(CSquirrel * pScript)
 {
-	for(iterator iter = begin(); iter != end(); ++ iter)
-		if((*iter) == pTimer)
-			return true;
+	for(std::map<unsigned int, CScriptTimer *>::iterator iter = m_timers.begin(); iter != m_timers.end(); )
+	{
+		CScriptTimer * pTimer = (*iter).second;
+		++ iter;
 
-	return false;
+		if(pTimer->GetScript() == pScript)
+			Kill(pTimer);
+	}
 }
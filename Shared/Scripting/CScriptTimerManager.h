@@ -15,11 +15,45 @@
 #include "CScriptingManager.h"
 #include "CScriptTimer.h"
 #include <list>
+#include <map>
 
-class CScriptTimerManager : public std::list<CScriptTimer *>
+// Timer wheel layout: the root level has one slot per millisecond, every slot of an outer level
+// covers the whole range of the level below it (8 + 4 * 6 bits covers the full 32 bit time range)
+#define TIMER_WHEEL_ROOT_BITS 8
+#define TIMER_WHEEL_LEVEL_BITS 6
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_ROOT_SIZE (1 << TIMER_WHEEL_ROOT_BITS)
+#define TIMER_WHEEL_LEVEL_SIZE (1 << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_ROOT_MASK (TIMER_WHEEL_ROOT_SIZE - 1)
+#define TIMER_WHEEL_LEVEL_MASK (TIMER_WHEEL_LEVEL_SIZE - 1)
+
+typedef std::list<CScriptTimer *> TimerWheelSlot;
+
+// Schedules the script timers on a hierarchical timer wheel so a pulse only
+// has to look at the timers which are due (and the odd cascade of an outer slot)
+class CScriptTimerManager
 {
+private:
+	std::map<unsigned int, CScriptTimer *> m_timers;
+	unsigned int   m_uiNextTimerId;
+	unsigned int   m_uiWheelTime;
+	TimerWheelSlot m_rootSlots[TIMER_WHEEL_ROOT_SIZE];
+	TimerWheelSlot m_levelSlots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_LEVEL_SIZE];
+	TimerWheelSlot m_dueTimers;
+
+	void           Schedule(CScriptTimer * pTimer);
+	void           Unschedule(CScriptTimer * pTimer);
+	unsigned int   Cascade(int iLevel);
+	void           Delete(CScriptTimer * pTimer);
+
 public:
-	void Pulse();
-	void HandleScriptUnload(CSquirrel * pScript);
-	bool contains(CScriptTimer* pTimer);
+	CScriptTimerManager();
+	~CScriptTimerManager();
+
+	unsigned int   Add(CScriptTimer * pTimer);
+	CScriptTimer * Get(unsigned int uiTimerId);
+	void           Kill(CScriptTimer * pTimer);
+	void           Pulse();
+	void           HandleScriptUnload(CSquirrel * pScript);
+	unsigned int   GetTimerCount() { return m_timers.size(); }
 };
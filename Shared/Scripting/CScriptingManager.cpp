@@ -14,6 +14,7 @@
 #include "CScriptingManager.h"
 #include "../CEvents.h"
 #include "../CLogFile.h"
+#include "../CSettings.h"
 #include <Common.h>
 
 // FIXUPDATE
@@ -773,6 +774,7 @@ CSquirrel * CScriptingManager::Load(String strName, String strPath)
 
 	if(!pScript->Execute())
 	{
+		g_pEvents->RemoveScript(pScript->GetVM());
 		delete pScript;
 		m_scripts.remove(pScript);
 		return NULL;
@@ -834,7 +836,10 @@ void CScriptingManager::UnloadAll()
 		std::list<CSquirrel*>::iterator iter;
 
 		for(iter = m_scripts.begin(); iter != m_scripts.end(); iter++)
+		{
+			g_pEvents->RemoveScript((*iter)->GetVM());
 			(*iter)->Unload();
+		}
 	}
 	m_scripts.clear();
 }
@@ -888,7 +893,12 @@ void CScriptingManager::RegisterConstant(String strConstantName, CSquirrelArgume
 
 void CScriptingManager::RegisterDefaultConstants()
 {
+#ifdef _SERVER
+	// The server only uses as many player slots as the maxplayers setting allows
+	RegisterConstant("MAX_PLAYERS", CVAR_GET_INTEGER("maxplayers"));
+#else
 	RegisterConstant("MAX_PLAYERS", MAX_PLAYERS);
+#endif
 	RegisterConstant("MAX_VEHICLES", MAX_VEHICLES);
 	RegisterConstant("MAX_OBJECTS", MAX_OBJECTS);
 	RegisterConstant("MAX_CHECKPOINTS", MAX_CHECKPOINTS);
@@ -19,13 +19,20 @@
 #include <Squirrel/sqstdstring.h>
 #include <Squirrel/sqstate.h>
 #include <Squirrel/sqvm.h>
+#include <Squirrel/sqtable.h>
 #include "../SharedUtility.h"
 #include "../CEvents.h"
 #include "../CLogFile.h"
 #include "CSquirrel.h"
+#include "CScriptProfiler.h"
+#ifdef _SERVER
+#include "../CSettings.h"
+#include <md5/md5.h>
+#endif
 
 extern CScriptingManager * g_pScriptingManager;
 extern CEvents * g_pEvents;
+extern CScriptProfiler * g_pScriptProfiler;
 
 void CSquirrel::PrintFunction(SQVM * pVM, const char * szFormat, ...)
 {
@@ -131,6 +138,8 @@ bool CSquirrel::Load(String strName, String strPath)
 
 	// Set the script path
 	m_strPath = strPath;
+	m_bFromCache = false;
+	m_ullCompileTime = 0;
 
 	// Create a squirrel VM with an initial stack size of 1024 bytes (stack will resize as needed)
 	m_pVM = sq_open(1024);
@@ -144,6 +153,10 @@ bool CSquirrel::Load(String strName, String strPath)
 	// Set the compiler error function
 	sq_setcompilererrorhandler(m_pVM, CompilerErrorFunction);
 
+	// Hook the script if the script profiler is running
+	if(g_pScriptProfiler)
+		g_pScriptProfiler->HandleScriptLoad(m_pVM);
+
 	// Push the root table onto the stack
 	sq_pushroottable(m_pVM);
 
@@ -172,17 +185,142 @@ bool CSquirrel::Execute()
 	RegisterConstant("SCRIPT_PATH", m_strPath);
 
 	// Load and compile the script
-	if(SQ_FAILED(sqstd_dofile(m_pVM, m_strPath.Get(), SQFalse, SQTrue)))
+	if(!Compile())
+		return false;
+
+	// Run the script with the root table as 'this'
+	sq_push(m_pVM, -2);
+	bool bSucceeded = SQ_SUCCEEDED(sq_call(m_pVM, 1, SQFalse, SQTrue));
+
+	// Pop the script closure from the stack
+	sq_pop(m_pVM, 1);
+	return bSucceeded;
+}
+
+SQInteger CSquirrel::ReadCacheFunction(SQUserPointer pFile, SQUserPointer pBuffer, SQInteger iSize)
+{
+	SQInteger iRead = (SQInteger)fread(pBuffer, 1, iSize, (FILE *)pFile);
+	return ((iRead != 0) ? iRead : -1);
+}
+
+SQInteger CSquirrel::WriteCacheFunction(SQUserPointer pFile, SQUserPointer pBuffer, SQInteger iSize)
+{
+	return (SQInteger)fwrite(pBuffer, 1, iSize, (FILE *)pFile);
+}
+
+bool CSquirrel::Compile()
+{
+	unsigned long long ullStartTime = SharedUtility::GetTimeMicroseconds();
+	m_bFromCache = false;
+
+#ifdef _SERVER
+	// Get the cache file of the script (named after its path) and the hash of the script source
+	String strCachePath;
+	MD5 sourceHash;
+	bool bCache = false;
+
+	if(CVAR_GET_BOOL("scriptcache"))
+	{
+		CMD5Hasher hasher;
+		MD5 pathHash;
+		char szPathHash[33];
+		hasher.Calculate(m_strPath.Get(), m_strPath.GetLength(), pathHash);
+		CMD5Hasher::ConvertToHex(pathHash, szPathHash);
+		strCachePath = SharedUtility::GetAbsolutePath("cache/scripts/%s.cnut", szPathHash);
+		bCache = hasher.Calculate(m_strPath.Get(), sourceHash);
+	}
+
+	// Is the script in the cache and the source unchanged since it was cached?
+	if(bCache && LoadFromCache(strCachePath, sourceHash))
+	{
+		m_bFromCache = true;
+		m_ullCompileTime = (SharedUtility::GetTimeMicroseconds() - ullStartTime);
+		return true;
+	}
+#endif
+
+	// Compile the script
+	SQInteger iConstCount = _table(_ss(m_pVM)->_consts)->CountUsed();
+
+	if(SQ_FAILED(sqstd_loadfile(m_pVM, m_strPath.Get(), SQTrue)))
 		return false;
 
+#ifdef _SERVER
+	// Add the compiled script to the cache (unless it declares consts or enums, they are added to the
+	// const table by the compiler and wouldn't be there for scripts compiled later if loaded from the cache)
+	if(bCache && _table(_ss(m_pVM)->_consts)->CountUsed() == iConstCount)
+		SaveToCache(strCachePath, sourceHash);
+#endif
+
+	m_ullCompileTime = (SharedUtility::GetTimeMicroseconds() - ullStartTime);
 	return true;
 }
 
+bool CSquirrel::LoadFromCache(String strCachePath, const unsigned char * ucSourceHash)
+{
+	FILE * pFile = fopen(strCachePath.Get(), "rb");
+
+	if(!pFile)
+		return false;
+
+	// Read and verify the header
+	char szMagic[4];
+	unsigned char ucVersion;
+	unsigned char ucSquirrelVersionLength;
+	char szSquirrelVersion[256];
+	unsigned char ucHash[16];
+	bool bValid = (fread(szMagic, 1, 4, pFile) == 4 && !memcmp(szMagic, SCRIPT_CACHE_MAGIC, 4) &&
+		fread(&ucVersion, 1, 1, pFile) == 1 && ucVersion == SCRIPT_CACHE_VERSION &&
+		fread(&ucSquirrelVersionLength, 1, 1, pFile) == 1 && fread(szSquirrelVersion, 1, ucSquirrelVersionLength, pFile) == ucSquirrelVersionLength &&
+		ucSquirrelVersionLength == strlen(SQUIRREL_VERSION) && !memcmp(szSquirrelVersion, SQUIRREL_VERSION, ucSquirrelVersionLength) &&
+		fread(ucHash, 1, 16, pFile) == 16 && !memcmp(ucHash, ucSourceHash, 16));
+
+	// Read the compiled script (a truncated or corrupt cache just gets compiled again)
+	if(bValid)
+		bValid = SQ_SUCCEEDED(sq_readclosure(m_pVM, ReadCacheFunction, pFile));
+
+	fclose(pFile);
+	return bValid;
+}
+
+void CSquirrel::SaveToCache(String strCachePath, const unsigned char * ucSourceHash)
+{
+	// Make sure the cache directory exists
+	SharedUtility::CreateDirectory(SharedUtility::GetAbsolutePath("cache"));
+	SharedUtility::CreateDirectory(SharedUtility::GetAbsolutePath("cache/scripts"));
+
+	FILE * pFile = fopen(strCachePath.Get(), "wb");
+
+	if(!pFile)
+		return;
+
+	// Write the header
+	unsigned char ucVersion = SCRIPT_CACHE_VERSION;
+	unsigned char ucSquirrelVersionLength = (unsigned char)strlen(SQUIRREL_VERSION);
+	fwrite(SCRIPT_CACHE_MAGIC, 1, 4, pFile);
+	fwrite(&ucVersion, 1, 1, pFile);
+	fwrite(&ucSquirrelVersionLength, 1, 1, pFile);
+	fwrite(SQUIRREL_VERSION, 1, ucSquirrelVersionLength, pFile);
+	fwrite(ucSourceHash, 1, 16, pFile);
+
+	// Write the compiled script (it stays on the stack)
+	bool bSucceeded = SQ_SUCCEEDED(sq_writeclosure(m_pVM, WriteCacheFunction, pFile));
+	fclose(pFile);
+
+	// Don't leave a partial cache behind
+	if(!bSucceeded)
+		remove(strCachePath.Get());
+}
+
 void CSquirrel::Unload()
 {
 	// Pop the root table from the stack
 	sq_pop(m_pVM, 1);
 
+	// Let the script profiler forget the functions of this script
+	if(g_pScriptProfiler)
+		g_pScriptProfiler->HandleScriptUnload();
+
 	// Close the squirrel VM
 	sq_close(m_pVM);
 	m_pVM = NULL;
@@ -16,6 +16,11 @@
 #include <Squirrel/sqobject.h>
 #include "CSquirrelArguments.h"
 
+// Compiled scripts are cached as "IVSC", the cache version, the squirrel version and the md5 of the
+// script source followed by the closure written by sq_writeclosure
+#define SCRIPT_CACHE_MAGIC "IVSC"
+#define SCRIPT_CACHE_VERSION 2
+
 #if defined(WIN32) && defined(RegisterClass)
 #undef RegisterClass
 #endif
@@ -47,14 +52,24 @@ private:
 	SQVM * m_pVM;
 	String m_strName;
 	String m_strPath;
+	bool   m_bFromCache;
+	unsigned long long m_ullCompileTime;
 
 	static void PrintFunction(SQVM * pVM, const char * szFormat, ...);
 	static void ErrorFunction(SQVM * pVM, const char * szFormat, ...);
 	static void CompilerErrorFunction(SQVM * pVM, const char * szError, const char * szSource, int iLine, int iColumn);
+	static SQInteger ReadCacheFunction(SQUserPointer pFile, SQUserPointer pBuffer, SQInteger iSize);
+	static SQInteger WriteCacheFunction(SQUserPointer pFile, SQUserPointer pBuffer, SQInteger iSize);
+
+	bool        Compile();
+	bool        LoadFromCache(String strCachePath, const unsigned char * ucSourceHash);
+	void        SaveToCache(String strCachePath, const unsigned char * ucSourceHash);
 
 public:
 	SQVM *      GetVM() { return m_pVM; }
 	String      GetName() { return m_strName; }
+	bool        IsFromCache() { return m_bFromCache; }
+	unsigned long long GetCompileTime() { return m_ullCompileTime; }
 	bool        Load(String strName, String strPath);
 	bool        Execute();
 	void        Unload();
@@ -8,6 +8,7 @@
 //==============================================================================
 
 #include "CSquirrelArguments.h"
+#include <new>
 #include <Squirrel/sqstate.h>
 #include <Squirrel/sqvm.h>
 #include <Squirrel/sqstring.h>
@@ -32,14 +33,20 @@ CSquirrelArgument::CSquirrelArgument(SQObject o)
 		break;
 	case OT_FLOAT:
 		data.f = o._unVal.fFloat;
+		break;
 	case OT_STRING:
-		data.str = new String(o._unVal.pString->_val);
+		SetStringData(o._unVal.pString->_val, o._unVal.pString->_len);
+		break;
 	case OT_NATIVECLOSURE:
 	case OT_CLOSURE:
 		data.sqObject = o;
+		break;
 	case OT_INSTANCE:
 		data.pInstance = o._unVal.pInstance;
 		break;
+	default:
+		type = OT_NULL;
+		break;
 	}
 }
 
@@ -61,13 +68,21 @@ CSquirrelArgument::~CSquirrelArgument()
 void CSquirrelArgument::reset()
 {
 	if(type == OT_STRING)
-		delete data.str;
+		GetStringData()->~String();
 	else if(type == OT_ARRAY || type == OT_TABLE)
 		delete data.pArray;
 
 	type = OT_NULL;
 }
 
+void CSquirrelArgument::SetStringData(const char * szString, size_t sLength)
+{
+	// Construct the string in place
+	new(data.ucString) String();
+	GetStringData()->Set(szString, sLength);
+	type = OT_STRING;
+}
+
 bool CSquirrelArgument::push(SQVM* pVM)
 {
 	switch(type)
@@ -85,7 +100,7 @@ bool CSquirrelArgument::push(SQVM* pVM)
 			sq_pushfloat(pVM, data.f);
 			break;
 		case OT_STRING:
-			sq_pushstring(pVM, data.str->Get(), data.str->GetLength());
+			sq_pushstring(pVM, GetStringData()->Get(), GetStringData()->GetLength());
 			break;
 		case OT_ARRAY:
 			{
@@ -93,7 +108,7 @@ bool CSquirrelArgument::push(SQVM* pVM)
 
 				for(CSquirrelArguments::iterator iter = data.pArray->begin(); iter != data.pArray->end(); iter++)
 				{
-					(*iter)->push(pVM);
+					iter->push(pVM);
 					sq_arrayappend(pVM, -2);
 				}
 				break;
@@ -105,9 +120,9 @@ bool CSquirrelArgument::push(SQVM* pVM)
 
 				for(CSquirrelArguments::iterator iter = data.pArray->begin(); iter != data.pArray->end(); iter++)
 				{
-					(*iter)->push(pVM);
+					iter->push(pVM);
 					++iter;
-					(*iter)->push(pVM);
+					iter->push(pVM);
 					sq_createslot(pVM, -3);
 				}
 				break;
@@ -286,7 +301,8 @@ void CSquirrelArgument::serialize(CBitStream * pBitStream)
 			break;
 		case OT_STRING:
 			{
-				size_t size = data.str->GetLength();
+				String * pString = GetStringData();
+				size_t size = pString->GetLength();
 				if(size <= 0xFF)
 				{
 					pBitStream->Write((unsigned char)NET_SQ_STRING_TINY);
@@ -303,7 +319,7 @@ void CSquirrelArgument::serialize(CBitStream * pBitStream)
 					pBitStream->Write(size);
 				}
 
-				pBitStream->Write(data.str->C_String(), data.str->GetLength());
+				pBitStream->Write(pString->C_String(), pString->GetLength());
 			}
 			break;
 		case OT_ARRAY:
@@ -408,11 +424,11 @@ void CSquirrelArgument::deserialize(CBitStream * pBitStream)
 				else
 					pBitStream->Read(size);
 
-				data.str = new String();
-				data.str->Resize(size);
-				char * szString = data.str->GetData();
+				String * pString = new(data.ucString) String();
+				pString->Resize(size);
+				char * szString = pString->GetData();
 				pBitStream->Read(szString, size);
-				data.str->Truncate(size);
+				pString->Truncate(size);
 			}
 			break;
 		case NET_SQ_TABLE:
@@ -424,6 +440,7 @@ void CSquirrelArgument::deserialize(CBitStream * pBitStream)
 			data.pArray = new CSquirrelArguments(pBitStream);
 			break;
 		default:
+			this->type = OT_NULL;
 			assert( 0 && "Invalid Data Type to Unserialize" );
 		}
 	}
@@ -447,7 +464,7 @@ void CSquirrelArgument::set(const CSquirrelArgument& p)
 		data.f = p.data.f;
 		break;
 	case OT_STRING:
-		data.str = new String(p.data.str->Get());
+		new(data.ucString) String(*p.GetStringData());
 		break;
 	case OT_ARRAY:
 	case OT_TABLE:
@@ -463,98 +480,201 @@ void CSquirrelArgument::set(const CSquirrelArgument& p)
 	}
 }
 
+void CSquirrelArgument::take(CSquirrelArgument& p)
+{
+	reset();
+
+	// Strings have to be copied as they are stored in place, everything else can just be moved over
+	if(p.type == OT_STRING)
+		set(p);
+	else
+	{
+		type = p.type;
+		data = p.data;
+		p.type = OT_NULL;
+	}
+
+	p.reset();
+}
+
 //==============================================================================
 
+CSquirrelArguments::CSquirrelArguments()
+{
+	m_uiSize = 0;
+	m_uiCapacity = SQUIRREL_ARGUMENTS_INLINE;
+}
+
 CSquirrelArguments::CSquirrelArguments(SQVM * pVM, int idx)
 {
+	m_uiSize = 0;
+	m_uiCapacity = SQUIRREL_ARGUMENTS_INLINE;
+
 	for(int i = idx; i <= sq_gettop(pVM); i++)
 		pushFromStack(pVM, i);
 }
 
 CSquirrelArguments::CSquirrelArguments(CBitStream * pBitStream)
 {
+	m_uiSize = 0;
+	m_uiCapacity = SQUIRREL_ARGUMENTS_INLINE;
 	deserialize(pBitStream);
 }
 
 CSquirrelArguments::CSquirrelArguments(const CSquirrelArguments& p)
 {
+	m_uiSize = 0;
+	m_uiCapacity = SQUIRREL_ARGUMENTS_INLINE;
+
 	for(CSquirrelArguments::const_iterator iter = p.begin(); iter != p.end(); ++ iter)
-		push_back(new CSquirrelArgument(**iter));
+		push_back()->set(*iter);
 }
 
 CSquirrelArguments::~CSquirrelArguments()
 {
 	reset();
+
+	// Free the overflow blocks
+	for(std::vector<CSquirrelArgument *>::iterator iter = m_blocks.begin(); iter != m_blocks.end(); iter++)
+		delete [] *iter;
+}
+
+CSquirrelArguments& CSquirrelArguments::operator=(const CSquirrelArguments& p)
+{
+	if(this != &p)
+	{
+		reset();
+
+		for(CSquirrelArguments::const_iterator iter = p.begin(); iter != p.end(); ++ iter)
+			push_back()->set(*iter);
+	}
+
+	return *this;
+}
+
+CSquirrelArgument * CSquirrelArguments::push_back()
+{
+	// Are we out of space? If so add a block as big as all storage so far (the existing arguments stay where they are)
+	if(m_uiSize == m_uiCapacity)
+	{
+		m_blocks.push_back(new CSquirrelArgument[m_uiCapacity]);
+		m_uiCapacity *= 2;
+	}
+
+	// Unused arguments are always null so this doesn't have to reset it
+	return at(m_uiSize++);
+}
+
+CSquirrelArgument * CSquirrelArguments::at(unsigned int i) const
+{
+	if(i < SQUIRREL_ARGUMENTS_INLINE)
+		return (CSquirrelArgument *)&m_inlineArguments[i];
+
+	// Find the block the argument is in (block n starts at SQUIRREL_ARGUMENTS_INLINE << n)
+	unsigned int uiBlock = 0;
+	unsigned int uiBlockStart = SQUIRREL_ARGUMENTS_INLINE;
+
+	while(i >= (uiBlockStart * 2))
+	{
+		uiBlockStart *= 2;
+		uiBlock++;
+	}
+
+	return &m_blocks[uiBlock][i - uiBlockStart];
+}
+
+void CSquirrelArguments::pop_front()
+{
+	if(m_uiSize == 0)
+		return;
+
+	// Move all other arguments down by one
+	for(unsigned int i = 1; i < m_uiSize; i++)
+		at(i - 1)->take(*at(i));
+
+	at(--m_uiSize)->reset();
+}
+
+void CSquirrelArguments::pop_back()
+{
+	if(m_uiSize == 0)
+		return;
+
+	at(--m_uiSize)->reset();
 }
 
 void CSquirrelArguments::reset()
 {
-	for(iterator iter = begin(); iter != end(); iter++)
-		delete *iter;
+	// Reset the arguments but keep the storage so the instance can be reused
+	for(unsigned int i = 0; i < m_uiSize; i++)
+		at(i)->reset();
 
-	clear();
+	m_uiSize = 0;
 }
 
 void CSquirrelArguments::push_to_vm(SQVM* pVM)
 {
 	for(iterator iter = begin(); iter != end(); ++ iter)
-		(*iter)->push(pVM);
+		iter->push(pVM);
 }
 
 void CSquirrelArguments::push()
 {
-	push_back(new CSquirrelArgument());
+	push_back();
 }
 
 void CSquirrelArguments::pushObject(SQObject o)
 {
-	push_back(new CSquirrelArgument(o));
+	CSquirrelArgument argument(o);
+	push_back()->take(argument);
 }
 
 void CSquirrelArguments::push(int i)
 {
-	push_back(new CSquirrelArgument(i));
+	push_back()->SetInteger(i);
 }
 
 void CSquirrelArguments::push(bool b)
 {
-	push_back(new CSquirrelArgument(b));
+	push_back()->SetBool(b);
 }
 
 void CSquirrelArguments::push(float f)
 {
-	push_back(new CSquirrelArgument(f));
+	push_back()->SetFloat(f);
 }
 
 void CSquirrelArguments::push(const char* c)
 {
-	push_back(new CSquirrelArgument(new String(c)));
+	push_back()->SetString(c);
 }
 
 void CSquirrelArguments::push(String str)
 {
-	push_back(new CSquirrelArgument(new String(str)));
+	push_back()->SetString(str.Get());
 }
 
 void CSquirrelArguments::push(CSquirrelArguments array, bool isArray)
 {
-	push_back(new CSquirrelArgument(array, isArray));
+	CSquirrelArgument argument(array, isArray);
+	push_back()->take(argument);
 }
 
 void CSquirrelArguments::push(CSquirrelArguments* pArray, bool isArray)
 {
-	push_back(new CSquirrelArgument(pArray, isArray));
+	if(isArray)
+		push_back()->SetArray(pArray);
+	else
+		push_back()->SetTable(pArray);
 }
 
 bool CSquirrelArguments::pushFromStack(SQVM* pVM, int idx)
 {
-	CSquirrelArgument * arg = new CSquirrelArgument();
+	CSquirrelArgument * arg = push_back();
 	bool bValid = arg->pushFromStack(pVM, idx);
 
-	if(bValid)
-		push_back(arg);
-	else
-		delete arg;
+	if(!bValid)
+		pop_back();
 
 	return bValid;
 }
@@ -564,15 +684,11 @@ CSquirrelArgument CSquirrelArguments::pop()
 	// Do we have an argument to pop?
 	if(size() > 0)
 	{
-		// Get an argument from the front
-		CSquirrelArgument * pArgument = front();
-		pop_front();
+		// Create a new instance of the argument from the front
+		CSquirrelArgument argument(*front());
 
-		// Create a new instance of the argument
-		CSquirrelArgument argument(*pArgument);
-
-		// Delete the argument
-		delete pArgument;
+		// Remove the argument
+		pop_front();
 
 		// Return the new argument instance
 		return argument;
@@ -605,7 +721,7 @@ void CSquirrelArguments::serialize(CBitStream * pBitStream)
 	// --
 
 	for(iterator iter = begin(); iter != end(); ++ iter)
-		(*iter)->serialize(pBitStream);
+		iter->serialize(pBitStream);
 }
 
 void CSquirrelArguments::deserialize(CBitStream * pBitStream)
@@ -627,7 +743,7 @@ void CSquirrelArguments::deserialize(CBitStream * pBitStream)
 		pBitStream->Read(size);
 
 	for(size_t i = 0; i < size; ++i)
-		push_back(new CSquirrelArgument(pBitStream));
+		push_back()->deserialize(pBitStream);
 }
 
 #ifdef _SERVER
@@ -636,15 +752,6 @@ SquirrelArgumentInterface* CSquirrelArguments::Get(unsigned int i) const
 	if(i >= size())
 		return 0;
 
-	unsigned int j = 0;
-	for(const_iterator iter = begin(); iter != end(); ++ iter)
-	{
-		if(j == i)
-			return *iter;
-		
-		++ j;
-	}
-
-	return 0;
+	return at(i);
 }
 #endif
@@ -10,13 +10,17 @@
 #pragma once
 
 #include <Squirrel/squirrel.h>
-#include <list>
+#include <CString.h>
 // FIXUPDATE
 // jenksta: this is very hacky :/
 #ifdef _SERVER
 #include "../../Server/Core/Interfaces/CEventsInterface.h"
 #endif
 #include <Network/CBitStream.h>
+#include <vector>
+
+// Number of arguments a CSquirrelArguments can hold before it has to allocate
+#define SQUIRREL_ARGUMENTS_INLINE 8
 
 class CSquirrelArguments;
 
@@ -26,15 +30,21 @@ class CSquirrelArgument
 #endif
 {
 	SQObjectType type;
+
+	// Strings are constructed in place (see data.ucString)
+	String             * GetStringData() const { return (String *)data.ucString; }
+	void                 SetStringData(const char * szString, size_t sLength);
+
 public:
 	union {
 		int i;
 		bool b;
 		float f;
-		String * str;
 		CSquirrelArguments * pArray;
 		SQObject sqObject;
 		SQInstance * pInstance;
+		// Storage for the string so short strings don't need a heap allocation
+		unsigned char ucString[sizeof(String)];
 	} data;
 
 	enum
@@ -61,16 +71,18 @@ public:
 	CSquirrelArgument(int i){type=OT_INTEGER; data.i=i;}
 	CSquirrelArgument(bool b){type=OT_BOOL; data.b=b;}
 	CSquirrelArgument(float f){type=OT_FLOAT; data.f=f;}
-	CSquirrelArgument(String str){type = OT_STRING; data.str = new String(str);}
-	CSquirrelArgument(String* str){type=OT_STRING; data.str=str;}
+	CSquirrelArgument(const char * szString){type=OT_NULL; SetString(szString);}
+	CSquirrelArgument(String str){type=OT_NULL; SetString(str.Get());}
 	CSquirrelArgument(CSquirrelArguments array, bool isArray);
 	CSquirrelArgument(CSquirrelArguments * pArray, bool isArray) { type = (isArray ? OT_ARRAY : OT_TABLE); data.pArray = pArray; }
 	CSquirrelArgument(SQObject o);
-	CSquirrelArgument(SQInstance * pInstance) {  }
+	CSquirrelArgument(SQInstance * pInstance) { type = OT_INSTANCE; data.pInstance = pInstance; }
 	CSquirrelArgument(CBitStream * pBitStream);
 	CSquirrelArgument(const CSquirrelArgument& p);
 	~CSquirrelArgument();
 
+	CSquirrelArgument&   operator=(const CSquirrelArgument& p) { if(this != &p) { reset(); set(p); } return *this; }
+
 	SQObjectType         GetType() const { return type; }
 
 	void                 reset();
@@ -82,11 +94,12 @@ public:
 	void                 deserialize(CBitStream * pBitStream);
 
 	void                 set(const CSquirrelArgument& p);
+	void                 take(CSquirrelArgument& p);
 	void                 SetNull()                 { reset(); type = OT_NULL; }
 	void                 SetInteger(int i)         { reset(); type = OT_INTEGER; data.i = i; }
 	void                 SetBool   (bool b)        { reset(); type = OT_BOOL; data.b = b; }
 	void                 SetFloat  (float f)       { reset(); type = OT_FLOAT; data.f = f; }
-	void                 SetString (const char* s) { reset(); type = OT_STRING; data.str = new String(s); }
+	void                 SetString (const char* s) { reset(); SetStringData(s, strlen(s)); }
 	void                 SetArray(CSquirrelArguments * pArray) { reset(); type = OT_ARRAY; data.pArray = pArray; }
 	void                 SetTable(CSquirrelArguments * pTable) { reset(); type = OT_TABLE; data.pArray = pTable; }
 	void                 SetInstance(SQInstance * pInstance) { reset(); type = OT_INSTANCE; data.pInstance = pInstance; }
@@ -94,24 +107,67 @@ public:
 	int                  GetInteger() const { return type == OT_INTEGER ? data.i : 0; }
 	bool                 GetBool()    const { return type == OT_BOOL    ? data.b : false; }
 	float                GetFloat()   const { return type == OT_FLOAT   ? data.f : 0.0f; }
-	const char         * GetString()  const { return type == OT_STRING  ? data.str->Get() : NULL; }
+	const char         * GetString()  const { return type == OT_STRING  ? GetStringData()->Get() : NULL; }
 	CSquirrelArguments * GetTable() const { return type == OT_TABLE ? data.pArray : NULL; }
 	CSquirrelArguments * GetArray() const { return type == OT_ARRAY ? data.pArray : NULL; }
 	SQInstance         * GetInstance() const { return type == OT_INSTANCE ? data.pInstance : NULL; }
 };
 
-class CSquirrelArguments : public std::list<CSquirrelArgument*>
+// List of arguments, the first SQUIRREL_ARGUMENTS_INLINE arguments are stored in the instance
+// itself so most event calls don't allocate, the rest in blocks which double in size. Arguments
+// never move once they are added so pointers from Add(), Get() and at() stay valid until the
+// argument is removed (pop_front moves the values of the other arguments down by one though)
+class CSquirrelArguments
 #ifdef _SERVER
-	, public SquirrelArgumentsInterface
+	: public SquirrelArgumentsInterface
 #endif
 {
+private:
+	unsigned int                     m_uiSize;
+	unsigned int                     m_uiCapacity;
+	CSquirrelArgument                m_inlineArguments[SQUIRREL_ARGUMENTS_INLINE];
+	std::vector<CSquirrelArgument *> m_blocks;
+
+	CSquirrelArgument * push_back();
+
 public:
-	CSquirrelArguments(){}
+	class iterator
+	{
+	private:
+		const CSquirrelArguments * m_pArguments;
+		unsigned int               m_uiIndex;
+
+	public:
+		iterator(const CSquirrelArguments * pArguments, unsigned int uiIndex) { m_pArguments = pArguments; m_uiIndex = uiIndex; }
+
+		CSquirrelArgument& operator*() const { return *m_pArguments->at(m_uiIndex); }
+		CSquirrelArgument* operator->() const { return m_pArguments->at(m_uiIndex); }
+		iterator&          operator++() { m_uiIndex++; return *this; }
+		iterator           operator++(int) { iterator iter = *this; m_uiIndex++; return iter; }
+		bool               operator==(const iterator& iter) const { return (m_uiIndex == iter.m_uiIndex); }
+		bool               operator!=(const iterator& iter) const { return (m_uiIndex != iter.m_uiIndex); }
+	};
+
+	typedef iterator const_iterator;
+
+	CSquirrelArguments();
 	CSquirrelArguments(SQVM * pVM, int idx);
 	CSquirrelArguments(CBitStream * pBitStream);
 	CSquirrelArguments(const CSquirrelArguments& p);
 	~CSquirrelArguments();
 
+	CSquirrelArguments& operator=(const CSquirrelArguments& p);
+
+	unsigned int        size() const { return m_uiSize; }
+	bool                empty() const { return (m_uiSize == 0); }
+	iterator            begin() const { return iterator(this, 0); }
+	iterator            end() const { return iterator(this, m_uiSize); }
+	CSquirrelArgument * front() { return at(0); }
+	CSquirrelArgument * back() { return at(m_uiSize - 1); }
+	CSquirrelArgument * at(unsigned int i) const;
+	void                pop_front();
+	void                pop_back();
+
 	void reset();
 
 	void push_to_vm(SQVM* pVM);
@@ -34,12 +34,19 @@ void RegisterTimerNatives(CScriptingManager * pScriptingManager)
 	pScriptingManager->RegisterClass(&_CLASS_DECL(timer));
 }
 
+// The timer instances store the timer id rather than the timer pointer so a
+// stale instance can't reach a timer which has been deleted (or a new one at the same address)
+static unsigned int GetTimerId(SQVM * pVM)
+{
+	return (unsigned int)(size_t)sq_getinstance<SQUserPointer>(pVM);
+}
+
 _MEMBER_FUNCTION_RELEASE_HOOK(timer)
 {
-	CScriptTimer * pTimer = (CScriptTimer *)pInst;
+	CScriptTimer * pTimer = g_pScriptTimerManager->Get((unsigned int)(size_t)pInst);
 
-	if(pTimer != NULL && g_pScriptTimerManager->contains(pTimer))
-		pTimer->Kill();
+	if(pTimer)
+		g_pScriptTimerManager->Kill(pTimer);
 
 	return 1;
 }
@@ -71,32 +78,34 @@ _MEMBER_FUNCTION_IMPL(timer, constructor)
 	CSquirrelArguments * pArguments = new CSquirrelArguments(pVM, 5);
 
 	CScriptTimer * pTimer = new CScriptTimer(g_pScriptingManager->Get(pVM), pFunction, interval, repeations, pArguments);
+	unsigned int uiTimerId = g_pScriptTimerManager->Add(pTimer);
 
-	if(SQ_FAILED(sq_setinstance(pVM, pTimer)))
+	if(SQ_FAILED(sq_setinstance(pVM, (SQUserPointer)(size_t)uiTimerId)))
 	{
-		delete pTimer;
-		delete pArguments;
+		// This deletes the arguments as well
+		g_pScriptTimerManager->Kill(pTimer);
 		sq_pushbool(pVM, false);
 		return 1;
 	}
 
-	g_pScriptTimerManager->push_back(pTimer);
 	sq_pushbool(pVM, true);
 	return 1;
 }
 
 _MEMBER_FUNCTION_IMPL(timer, isActive)
 {
-	CScriptTimer * pTimer = sq_getinstance<CScriptTimer *>(pVM);
+	unsigned int uiTimerId = GetTimerId(pVM);
 
-	if(!pTimer)
+	if(!uiTimerId)
 	{
 		CLogFile::Print("Failed to get the timer instance.");
 		sq_pushbool(pVM, false);
 		return 1;
 	}
 
-	if(g_pScriptTimerManager->contains(pTimer))
+	CScriptTimer * pTimer = g_pScriptTimerManager->Get(uiTimerId);
+
+	if(pTimer)
 	{
 		if(pTimer->IsDead())
 		{
@@ -115,18 +124,20 @@ _MEMBER_FUNCTION_IMPL(timer, isActive)
 
 _MEMBER_FUNCTION_IMPL(timer, kill)
 {
-	CScriptTimer * pTimer = sq_getinstance<CScriptTimer *>(pVM);
+	unsigned int uiTimerId = GetTimerId(pVM);
 
-	if(!pTimer)
+	if(!uiTimerId)
 	{
 		CLogFile::Print("Failed to get the timer instance.");
 		sq_pushbool(pVM, false);
 		return 1;
 	}
 
-	if(g_pScriptTimerManager->contains(pTimer) && !pTimer->IsDead())
+	CScriptTimer * pTimer = g_pScriptTimerManager->Get(uiTimerId);
+
+	if(pTimer && !pTimer->IsDead())
 	{
-		pTimer->Kill();
+		g_pScriptTimerManager->Kill(pTimer);
 		sq_pushbool(pVM, true);
 		sq_setinstance(pVM, NULL);
 		return 1;
@@ -138,16 +149,18 @@ _MEMBER_FUNCTION_IMPL(timer, kill)
 
 _MEMBER_FUNCTION_IMPL(timer, setTraditionalBehavior)
 {
-	CScriptTimer * pTimer = sq_getinstance<CScriptTimer *>(pVM);
+	unsigned int uiTimerId = GetTimerId(pVM);
 
-	if(!pTimer)
+	if(!uiTimerId)
 	{
 		CLogFile::Print("Failed to get the timer instance.");
 		sq_pushbool(pVM, false);
 		return 1;
 	}
 
-	if(pTimer != 0 && g_pScriptTimerManager->contains(pTimer) && !pTimer->IsDead())
+	CScriptTimer * pTimer = g_pScriptTimerManager->Get(uiTimerId);
+
+	if(pTimer && !pTimer->IsDead())
 	{
 		bool b;
 		sq_getbool(pVM, 2, (SQBool*)&b);
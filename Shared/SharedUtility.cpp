@@ -428,6 +428,26 @@ namespace SharedUtility
 #endif
 	}
 
+	unsigned long long GetTimeMicroseconds()
+	{
+#ifdef WIN32
+		static LARGE_INTEGER liFrequency = { 0 };
+
+		// Get the performance counter frequency if we don't have it yet
+		if(liFrequency.QuadPart == 0)
+			QueryPerformanceFrequency(&liFrequency);
+
+		LARGE_INTEGER liCounter;
+		QueryPerformanceCounter(&liCounter);
+		return (unsigned long long)((liCounter.QuadPart / liFrequency.QuadPart) * 1000000 +
+			((liCounter.QuadPart % liFrequency.QuadPart) * 1000000) / liFrequency.QuadPart);
+#else
+		timeval ts;
+		gettimeofday(&ts, 0);
+		return ((unsigned long long)ts.tv_sec * 1000000 + ts.tv_usec);
+#endif
+	}
+
 	bool Exists(const char * szPath)
 	{
 		struct stat St;
@@ -95,6 +95,10 @@ const char * GetTimeString();
 // 
 unsigned long GetTime();
 
+// Returns a high resolution time in microseconds
+// (only useful for measuring time differences)
+unsigned long long GetTimeMicroseconds();
+
 // Check if a path exists
 bool Exists(const char * szPath);
 